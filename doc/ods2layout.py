@@ -0,0 +1,368 @@
+#!/usr/bin/env python3
+"""
+Generate the mailbox field tables and layout checks from the interface spreadsheet.
+
+usage: ods2layout.py <spreadsheet.ods> <header.h> <source.c>
+
+The spreadsheet documents one mailbox version. Later versions which are not yet
+reflected in the spreadsheet are described as patches in REVISIONS below.
+"""
+
+import re
+import sys
+import zipfile
+import xml.etree.ElementTree as ET
+
+NS_TABLE = '{urn:oasis:names:tc:opendocument:xmlns:table:1.0}'
+NS_TEXT = '{urn:oasis:names:tc:opendocument:xmlns:text:1.0}'
+
+MEMORY_MAP = 'Memory Map'
+
+# Spreadsheet names -> C member names (None: not part of mb_memory_contents_t)
+NAME_MAP = {
+    'Memory Map': {
+        'MMC Mailbox Magic String': 'mailbox_magic_str',
+        'MMC Mailbox Version': 'mailbox_version',
+        'FRU #0 Information': 'fru_information[0]',
+        'FRU #1 Information': 'fru_information[1]',
+        'FRU #2 Information': 'fru_information[2]',
+        'FRU #3 Information': 'fru_information[3]',
+        'Application-specific': 'application_data',
+        'Information about MMC': 'mmc_information',
+        'Sensor #0..#39': 'mmc_sensor',
+        'Reserved': 'reserved',
+        'Backplane Ethernet Addresses': 'bp_eth_info',
+        'FPGA Control': 'fpga_ctrl',
+        'FPGA Status': 'fpga_status',
+        'Lock Register': None,
+    },
+    'FRU Information': {
+        'Status': 'status',
+        'Description': 'description',
+    },
+    'FRU Status': {
+        'Status': 'flags',
+        'Num. Temperature Sensors': 'num_temp_sensors',
+        'Temperature #1..#8': 'temperature',
+        'FRU-type specific': 'ext',
+    },
+    'FRU Description': {
+        'UID': 'uid',
+        'Manufacturer': 'manufacturer',
+        'Product': 'product',
+        'Part number': 'part_nr',
+        'Serial number': 'serial_nr',
+        'Version': 'version',
+    },
+    'MMC Sensor': {
+        'Sensor name': 'name',
+        'Sensor reading': 'reading',
+    },
+    'MMC Information': {
+        'Application version': 'application_version',
+        'Library version': 'library_version',
+        'CPLD board version': 'cpld_board_version',
+        'CPLD library version': 'cpld_library_version',
+        'STAMP HW Revision': 'stamp_hw_revision',
+        'AMC Slot Number': 'amc_slot_nr',
+        'AMC IPMB Address': 'ipmb_addr',
+        'Board Name': 'board_name',
+        'Vendor ID': 'vendor_id',
+        'Product ID': 'product_id',
+        'MMC Uptime': 'mmc_uptime',
+        'AMC HW Revision': 'amc_hw_revision',
+        'Reserved': 'reserved',
+    },
+    'Version Number': {
+        'Major version': 'major',
+        'Minor version': 'minor',
+    },
+    'NIC Information': {
+        'MAC address': 'mac_addr',
+        'IPv4 address': 'ipv4_addr',
+        'IPv6 address': 'ipv6_addr',
+    },
+}
+
+# Elementary spreadsheet types -> (C field type, element size)
+ELEM_TYPES = {
+    'char': ('MB_FIELD_CHAR', 1),
+    'u8': ('MB_FIELD_U8', 1),
+    'u16': ('MB_FIELD_U16', 2),
+    's16': ('MB_FIELD_S16', 2),
+    'u32': ('MB_FIELD_U32', 4),
+    'float': ('MB_FIELD_FLOAT', 4),
+    'Bitfield': ('MB_FIELD_BITS', 1),
+    'None': ('MB_FIELD_RAW', 1),
+}
+
+# Expand arrays of these types into one field per element
+EXPAND_ARRAYS = ('u16', 's16', 'u32', 'float')
+
+# Layout revisions not yet in the spreadsheet: version -> {table: [(offs, size, type, name)]}
+# Patch rows replace the rows they overlap, patches are applied in ascending version order.
+REVISIONS = {
+    3: {
+        'MMC Information': [
+            (42, 1, 'char', 'AMC HW Revision'),
+            (43, 5, 'None', 'Reserved'),
+        ],
+    },
+}
+
+
+def cell_text(cell):
+    return '\n'.join(''.join(p.itertext()) for p in cell.iter(NS_TEXT + 'p'))
+
+
+def read_rows(path):
+    root = ET.fromstring(zipfile.ZipFile(path).read('content.xml'))
+    table = next(root.iter(NS_TABLE + 'table'))
+    for row in table.iter(NS_TABLE + 'table-row'):
+        cells = []
+        for cell in row.findall(NS_TABLE + 'table-cell'):
+            rep = int(cell.get(NS_TABLE + 'number-columns-repeated', '1'))
+            cells += [cell_text(cell)] * min(rep, 8)
+        yield (cells + [''] * 6)[:6]
+
+
+def parse_tables(path):
+    """Returns {table name: [(offs, size, type, name, contents)]}"""
+    tables, cur = {}, None
+    for title, offs, size, typ, name, contents in read_rows(path):
+        if title == 'Size:':
+            cur = None
+        elif title and not offs:
+            cur = title
+            tables[cur] = []
+        elif cur and offs.isdigit():
+            tables[cur].append((int(offs), int(size), typ.strip(), name.strip(), contents))
+    return tables
+
+
+def doc_version(tables):
+    for offs, size, typ, name, contents in tables[MEMORY_MAP]:
+        if NAME_MAP[MEMORY_MAP].get(name) == 'mailbox_version':
+            return int(contents)
+    raise ValueError('Mailbox version not found in spreadsheet')
+
+
+def flatten(tables, table, base_offs, prefix):
+    """Yields (c_name, offs, size, field_type, is_member) for all leaf fields"""
+    for row in tables[table]:
+        offs, size, typ, name = row[:4]
+        c_name = NAME_MAP[table][name]
+        if c_name is None:
+            continue
+        path = prefix + c_name
+        offs += base_offs
+        m = re.fullmatch(r'(.+?)\s*\[\]', typ)
+        elem = m.group(1) if m else typ
+        if elem in tables:
+            elem_size = sum(r[1] for r in tables[elem])
+            if m:
+                for i in range(size // elem_size):
+                    yield from flatten(tables, elem, offs + i * elem_size, f'{path}[{i}].')
+            else:
+                yield from flatten(tables, elem, offs, path + '.')
+        elif elem in ELEM_TYPES:
+            field_type, elem_size = ELEM_TYPES[elem]
+            # Bitfields are not addressable, except for whole-byte top-level members
+            is_member = elem != 'Bitfield' or not prefix
+            if m and elem in EXPAND_ARRAYS:
+                for i in range(size // elem_size):
+                    yield (f'{path}[{i}]', offs + i * elem_size, elem_size, field_type, is_member)
+            else:
+                yield (path, offs, size, field_type, is_member)
+        else:
+            raise ValueError(f'Unknown type "{typ}" in table "{table}"')
+
+
+def apply_revision(tables, patch):
+    patched = dict(tables)
+    for table, rows in patch.items():
+        new_rows = [(offs, size, typ, name, '') for offs, size, typ, name in rows]
+        # Drop the rows overlapped by the patch rows
+        kept = [r for r in tables[table]
+                if not any(r[0] < n[0] + n[1] and n[0] < r[0] + r[1] for n in new_rows)]
+        patched[table] = sorted(kept + new_rows)
+    return patched
+
+
+BANNER = '''/***************************************************************************
+ *      ____  _____________  __    __  __ _           _____ ___   _        *
+ *     / __ \\/ ____/ ___/\\ \\/ /   |  \\/  (_)__ _ _ __|_   _/ __| /_\\  (R)  *
+ *    / / / / __/  \\__ \\  \\  /    | |\\/| | / _| '_/ _ \\| || (__ / _ \\      *
+ *   / /_/ / /___ ___/ /  / /     |_|  |_|_\\__|_| \\___/|_| \\___/_/ \\_\\     *
+ *  /_____/_____//____/  /_/      T  E  C  H  N  O  L  O  G  Y   L A B     *
+ *                                                                         *
+ *          Copyright 2022 Deutsches Elektronen-Synchrotron DESY.          *
+ *                          All rights reserved.                           *
+ *                                                                         *
+ ***************************************************************************/
+
+/* Generated from {src} by doc/ods2layout.py, do not edit */
+'''
+
+
+def write_header(f, src, versions, latest_fields):
+    f.write(BANNER.format(src=src))
+    f.write('''
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+''')
+    f.write(f'#define MB_VERSION_MIN {min(versions)}\n')
+    f.write(f'#define MB_VERSION_MAX {max(versions)}\n')
+    f.write('''
+typedef enum mb_field_type {
+    MB_FIELD_RAW,
+    MB_FIELD_CHAR,
+    MB_FIELD_U8,
+    MB_FIELD_U16,
+    MB_FIELD_S16,
+    MB_FIELD_U32,
+    MB_FIELD_FLOAT,
+    MB_FIELD_BITS,
+} mb_field_type_t;
+
+typedef struct mb_field_desc {
+    const char* name;
+    uint16_t offs;
+    uint16_t size;
+    mb_field_type_t type;
+} mb_field_desc_t;
+
+// Per-version layout description
+typedef struct mb_version_desc {
+    unsigned version;
+    const mb_field_desc_t* fields;
+    size_t num_fields;
+    // Fields of mb_memory_contents_t (latest version) which this version doesn't define
+    const mb_field_desc_t* undefined;
+    size_t num_undefined;
+} mb_version_desc_t;
+
+// Get the layout description of mailbox <version>, returns NULL if the version is unknown
+const mb_version_desc_t* mb_get_version_desc(unsigned version);
+
+// Get the field table of mailbox <version>, returns NULL if the version is unknown
+const mb_field_desc_t* mb_get_fields(unsigned version, size_t* num_fields);
+
+// Zero the fields not defined by <desc> in <buf>, which holds mailbox bytes [offs, offs + len)
+void mb_clear_undefined(const mb_version_desc_t* desc, void* buf, size_t offs, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+/* Check mb_memory_contents_t for consistency with the memory map */
+''')
+    f.write(f'#if MB_LAYOUT_VERSION != {max(versions)}\n')
+    f.write('#error "mb_memory_contents_t does not match the latest documented mailbox version"\n')
+    f.write('#endif\n\n')
+    for name, offs, size, field_type, is_member in latest_fields:
+        if not is_member:
+            continue
+        f.write(f'static_assert(MB_EEPROM_OFFS({name}) == {offs}, "Offset of {name} incorrect");\n')
+        f.write(f'static_assert(sizeof(MB_MEM_DUMMY->{name}) == {size}, "Size of {name} incorrect");\n')
+
+
+def undefined_fields(fields, latest_fields):
+    """Fields of the latest version which <fields> doesn't have"""
+    names = {name for name, *_ in fields}
+    return [fld for fld in latest_fields if fld[0] not in names]
+
+
+def write_fields(f, array, fields):
+    f.write(f'\nstatic const mb_field_desc_t {array}[] = {{\n')
+    for name, offs, size, field_type, is_member in fields:
+        f.write(f'    {{"{name}", {offs}, {size}, {field_type}}},\n')
+    f.write('};\n')
+
+
+def write_source(f, src, fields_by_version):
+    f.write(BANNER.format(src=src))
+    f.write('''
+#include <stddef.h>
+#include <string.h>
+
+#include "mmcmb/fpga_mailbox_layout.h"
+
+#define NUM_ELEMS(x) (sizeof(x) / sizeof((x)[0]))
+''')
+    latest_fields = fields_by_version[max(fields_by_version)]
+    entries = []
+    for version, fields in fields_by_version.items():
+        write_fields(f, f'fields_v{version}', fields)
+        undefined = undefined_fields(fields, latest_fields)
+        if undefined:
+            write_fields(f, f'undefined_v{version}', undefined)
+            undef = f'undefined_v{version}, NUM_ELEMS(undefined_v{version})'
+        else:
+            undef = 'NULL, 0'
+        entries.append(f'{{{version}, fields_v{version}, NUM_ELEMS(fields_v{version}), {undef}}}')
+    f.write('\nstatic const mb_version_desc_t versions[] = {\n')
+    for entry in entries:
+        f.write(f'    {entry},\n')
+    f.write('};\n')
+    f.write('''
+const mb_version_desc_t* mb_get_version_desc(unsigned version)
+{
+    for (size_t i = 0; i < NUM_ELEMS(versions); i++) {
+        if (versions[i].version == version) {
+            return &versions[i];
+        }
+    }
+    return NULL;
+}
+
+const mb_field_desc_t* mb_get_fields(unsigned version, size_t* num_fields)
+{
+    const mb_version_desc_t* desc = mb_get_version_desc(version);
+    *num_fields = desc ? desc->num_fields : 0;
+    return desc ? desc->fields : NULL;
+}
+
+void mb_clear_undefined(const mb_version_desc_t* desc, void* buf, size_t offs, size_t len)
+{
+    for (size_t i = 0; i < desc->num_undefined; i++) {
+        const mb_field_desc_t* fd = &desc->undefined[i];
+        const size_t start = fd->offs > offs ? fd->offs : offs;
+        const size_t end = fd->offs + fd->size < offs + len ? fd->offs + fd->size : offs + len;
+        if (start < end) {
+            memset((char*)buf + (start - offs), 0, end - start);
+        }
+    }
+}
+''')
+
+
+def main():
+    if len(sys.argv) != 4:
+        sys.exit(__doc__)
+    src, header, source = sys.argv[1:]
+
+    tables = parse_tables(src)
+    base_version = doc_version(tables)
+
+    fields_by_version = {base_version: list(flatten(tables, MEMORY_MAP, 0, ''))}
+    for version, patch in sorted(REVISIONS.items()):
+        tables = apply_revision(tables, patch)
+        fields_by_version[version] = list(flatten(tables, MEMORY_MAP, 0, ''))
+    versions = list(fields_by_version)
+
+    with open(header, 'w') as f:
+        write_header(f, src, versions, fields_by_version[max(versions)])
+    with open(source, 'w') as f:
+        write_source(f, src, fields_by_version)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,181 @@
+/***************************************************************************
+ *      ____  _____________  __    __  __ _           _____ ___   _        *
+ *     / __ \/ ____/ ___/\ \/ /   |  \/  (_)__ _ _ __|_   _/ __| /_\  (R)  *
+ *    / / / / __/  \__ \  \  /    | |\/| | / _| '_/ _ \| || (__ / _ \      *
+ *   / /_/ / /___ ___/ /  / /     |_|  |_|_\__|_| \___/|_| \___/_/ \_\     *
+ *  /_____/_____//____/  /_/      T  E  C  H  N  O  L  O  G  Y   L A B     *
+ *                                                                         *
+ *          Copyright 2022 Deutsches Elektronen-Synchrotron DESY.          *
+ *                          All rights reserved.                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include <signal.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "mmcmb/mmcmb.h"
+#include "mmcmb/mmcmb_archive.h"
+
+#define NS_PER_SEC 1000000000ull
+
+// Default: one snapshot per second (MMC update rate), keyframe every minute
+#define DEFAULT_INTERVAL_MS 1000
+#define DEFAULT_KEYFRAME_INTERVAL 60
+
+static volatile sig_atomic_t terminate = false;
+
+static void sig_handler(int signum)
+{
+    (void)signum;
+    terminate = true;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return ts.tv_sec * NS_PER_SEC + ts.tv_nsec;
+}
+
+// Parse a UNIX timestamp in (fractional) seconds
+static bool parse_time(const char* str, uint64_t* t_ns)
+{
+    char* end;
+    const double t = strtod(str, &end);
+    if (*end != '\0' || t < 0) {
+        fprintf(stderr, "Invalid timestamp '%s'\n", str);
+        return false;
+    }
+    *t_ns = t * NS_PER_SEC;
+    return true;
+}
+
+static int cmd_record(const char* path, unsigned interval_ms, unsigned long count)
+{
+    if (!mb_check_magic()) {
+        fprintf(stderr, "Mailbox not available\r\n");
+        return 1;
+    }
+
+    mb_archive_writer_t* w = mb_archive_create(path, DEFAULT_KEYFRAME_INTERVAL);
+    if (!w) {
+        return 1;
+    }
+
+    struct sigaction action = {
+        .sa_handler = sig_handler,
+    };
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    const struct timespec ts_interval = {
+        .tv_sec = interval_ms / 1000,
+        .tv_nsec = (interval_ms % 1000) * 1000000l,
+    };
+
+    bool ok = true;
+    for (unsigned long i = 0; !terminate && (!count || i < count); i++) {
+        mb_memory_contents_t snap;
+        if (!mb_get_snapshot(&snap) || !mb_archive_append(w, now_ns(), &snap)) {
+            ok = false;
+            break;
+        }
+        nanosleep(&ts_interval, NULL);
+    }
+
+    return mb_archive_finish(w) && ok ? 0 : 1;
+}
+
+static int cmd_info(const char* path)
+{
+    mb_archive_t* ar = mb_archive_open(path);
+    if (!ar) {
+        return 1;
+    }
+    const uint64_t t0 = mb_archive_first_timestamp(ar), t1 = mb_archive_last_timestamp(ar);
+    printf("%-10s: %zu\n", "Keyframes", mb_archive_num_keyframes(ar));
+    printf("%-10s: %.3f\n", "First", (double)t0 / NS_PER_SEC);
+    printf("%-10s: %.3f\n", "Last", (double)t1 / NS_PER_SEC);
+    printf("%-10s: %.3f s\n", "Duration", (double)(t1 - t0) / NS_PER_SEC);
+    mb_archive_close(ar);
+    return 0;
+}
+
+typedef struct extract_ctx {
+    const char* name;
+    size_t slot;  // Cached sensor slot, re-checked on every snapshot
+} extract_ctx_t;
+
+// Compare a (possibly unterminated) sensor name field with <name>, whole names only
+static bool sensor_name_eq(const mb_mmc_sensor_t* sen, const char* name)
+{
+    const size_t len = strlen(name);
+    return len == strnlen(sen->name, sizeof(sen->name)) && !memcmp(sen->name, name, len);
+}
+
+static bool extract_cb(uint64_t timestamp_ns, const mb_memory_contents_t* snap, void* arg)
+{
+    extract_ctx_t* ctx = arg;
+
+    if (ctx->slot >= MAX_SENS_MMC || !sensor_name_eq(&snap->mmc_sensor[ctx->slot], ctx->name)) {
+        for (ctx->slot = 0; ctx->slot < MAX_SENS_MMC; ctx->slot++) {
+            if (sensor_name_eq(&snap->mmc_sensor[ctx->slot], ctx->name)) {
+                break;
+            }
+        }
+    }
+    if (ctx->slot < MAX_SENS_MMC) {
+        printf("%.3f,%g\n", (double)timestamp_ns / NS_PER_SEC, snap->mmc_sensor[ctx->slot].reading);
+    }
+    return true;
+}
+
+static int cmd_extract(const char* path, const char* sensor, uint64_t t0, uint64_t t1)
+{
+    mb_archive_t* ar = mb_archive_open(path);
+    if (!ar) {
+        return 1;
+    }
+    extract_ctx_t ctx = {
+        .name = sensor,
+        .slot = MAX_SENS_MMC,
+    };
+    printf("timestamp,%s\n", sensor);
+    const bool ok = mb_archive_query(ar, t0, t1, extract_cb, &ctx);
+    mb_archive_close(ar);
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc >= 3 && !strcmp(argv[1], "record") && argc <= 5) {
+        const unsigned interval_ms = argc >= 4 ? strtoul(argv[3], NULL, 0) : DEFAULT_INTERVAL_MS;
+        const unsigned long count = argc >= 5 ? strtoul(argv[4], NULL, 0) : 0;
+        return cmd_record(argv[2], interval_ms, count);
+    }
+    if (argc == 3 && !strcmp(argv[1], "info")) {
+        return cmd_info(argv[2]);
+    }
+    if (argc >= 4 && !strcmp(argv[1], "extract") && argc <= 6) {
+        uint64_t t0 = 0, t1 = UINT64_MAX;
+        if ((argc >= 5 && !parse_time(argv[4], &t0)) || (argc >= 6 && !parse_time(argv[5], &t1))) {
+            return 1;
+        }
+        return cmd_extract(argv[2], argv[3], t0, t1);
+    }
+
+    fprintf(stderr,
+            "usage: %s record <file> [interval_ms] [count]\r\n"
+            "       %s info <file>\r\n"
+            "       %s extract <file> <sensor> [t0] [t1]\r\n",
+            argv[0],
+            argv[0],
+            argv[0]);
+    return 1;
+}
@@ -0,0 +1,545 @@
+/***************************************************************************
+ *      ____  _____________  __    __  __ _           _____ ___   _        *
+ *     / __ \/ ____/ ___/\ \/ /   |  \/  (_)__ _ _ __|_   _/ __| /_\  (R)  *
+ *    / / / / __/  \__ \  \  /    | |\/| | / _| '_/ _ \| || (__ / _ \      *
+ *   / /_/ / /___ ___/ /  / /     |_|  |_|_\__|_| \___/|_| \___/_/ \_\     *
+ *  /_____/_____//____/  /_/      T  E  C  H  N  O  L  O  G  Y   L A B     *
+ *                                                                         *
+ *          Copyright 2022 Deutsches Elektronen-Synchrotron DESY.          *
+ *                          All rights reserved.                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#define _GNU_SOURCE  // accept4()
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "mmcmb/fpga_mailbox_layout.h"
+#include "mmcmb/mmcmb_stream.h"
+
+/* Crate collector
+ *
+ * Merges the snapshot streams of several boards (mmcctrld MMCCTRLD_SOCKET sockets, or
+ * mailbox image files standing in for a board) into one crate view, keyed by AMC slot
+ * number & IPMB address. Clients connecting to the collector's socket get the whole
+ * crate view at once, then the deltas of every board as they come in.
+ */
+
+#define DEFAULT_SOCKET "/run/mmccrated.sock"
+
+#define MAX_SOURCES 32
+#define MAX_CLIENTS 16
+
+// Reconnect sources / check image files for changes once per second
+#define SCAN_INTERVAL_MS 1000
+
+#define NS_PER_SEC 1000000000ull
+
+typedef struct source {
+    const char* path;
+    int fd;                 // Stream socket, -1 if not connected
+    struct timespec mtime;  // Image file modification time
+    mb_stream_rx_t rx;
+
+    // Board state
+    bool valid;
+    uint64_t timestamp_ns;
+    mb_memory_contents_t snap;
+
+    // Crate view entry (the first source to report a slot/address owns it)
+    bool published;
+    bool conflict_reported;
+    uint8_t amc_slot_nr;
+    uint8_t ipmb_addr;
+} source_t;
+
+static source_t sources[MAX_SOURCES];
+static size_t num_sources = 0;
+
+static int clients[MAX_CLIENTS];
+
+static volatile sig_atomic_t terminate = false;
+
+static void sig_handler(int signum)
+{
+    (void)signum;
+    terminate = true;
+}
+
+static uint64_t timespec_ns(const struct timespec* ts)
+{
+    return ts->tv_sec * NS_PER_SEC + ts->tv_nsec;
+}
+
+static void drop_client(size_t i)
+{
+    close(clients[i]);
+    clients[i] = -1;
+}
+
+static void broadcast(const mb_stream_hdr_t* hdr, const void* payload)
+{
+    for (size_t i = 0; i < MAX_CLIENTS; i++) {
+        if (clients[i] >= 0 && !mb_stream_send(clients[i], hdr, payload)) {
+            drop_client(i);
+        }
+    }
+}
+
+static void broadcast_snapshot(const source_t* s, const mb_memory_contents_t* prev)
+{
+    for (size_t i = 0; i < MAX_CLIENTS; i++) {
+        if (clients[i] < 0) {
+            continue;
+        }
+        if (!mb_stream_send_snapshot(clients[i], s->timestamp_ns, prev, &s->snap)) {
+            drop_client(i);
+        }
+    }
+}
+
+static void unpublish(source_t* s)
+{
+    if (!s->published) {
+        return;
+    }
+    const mb_stream_hdr_t hdr = {
+        .magic = MB_STREAM_MAGIC,
+        .type = MB_STREAM_REMOVE,
+        .amc_slot_nr = s->amc_slot_nr,
+        .ipmb_addr = s->ipmb_addr,
+    };
+    broadcast(&hdr, NULL);
+    s->published = false;
+}
+
+static const source_t* find_board(uint8_t amc_slot_nr, uint8_t ipmb_addr)
+{
+    for (size_t i = 0; i < num_sources; i++) {
+        const source_t* s = &sources[i];
+        if (s->published && s->amc_slot_nr == amc_slot_nr && s->ipmb_addr == ipmb_addr) {
+            return s;
+        }
+    }
+    return NULL;
+}
+
+// Publish the new board state of <s>, as a delta against <prev> if it is known to clients
+static void board_update(source_t* s, const mb_memory_contents_t* prev)
+{
+    const uint8_t amc_slot_nr = s->snap.mmc_information.amc_slot_nr;
+    const uint8_t ipmb_addr = s->snap.mmc_information.ipmb_addr;
+
+    if (s->published && (s->amc_slot_nr != amc_slot_nr || s->ipmb_addr != ipmb_addr)) {
+        unpublish(s);
+    }
+    if (!s->published) {
+        const source_t* owner = find_board(amc_slot_nr, ipmb_addr);
+        if (owner) {
+            if (!s->conflict_reported) {
+                fprintf(stderr,
+                        "%s: slot %u / IPMB 0x%02x already reported by %s, ignored\n",
+                        s->path,
+                        amc_slot_nr,
+                        ipmb_addr,
+                        owner->path);
+                s->conflict_reported = true;
+            }
+            return;
+        }
+        s->published = true;
+        s->conflict_reported = false;
+        s->amc_slot_nr = amc_slot_nr;
+        s->ipmb_addr = ipmb_addr;
+        prev = NULL;
+    }
+    broadcast_snapshot(s, prev);
+}
+
+static void source_lost(source_t* s)
+{
+    if (s->fd >= 0) {
+        close(s->fd);
+        s->fd = -1;
+    }
+    if (s->valid) {
+        fprintf(stderr, "%s: lost\n", s->path);
+    }
+    s->valid = false;
+    s->mtime = (struct timespec){0};
+    unpublish(s);
+}
+
+// Handle a message received from stream source <s>, returns false on protocol errors
+static bool source_message(source_t* s)
+{
+    const mb_stream_hdr_t* hdr = &s->rx.hdr;
+    if (hdr->type != MB_STREAM_KEYFRAME && hdr->type != MB_STREAM_DELTA) {
+        return hdr->type == MB_STREAM_SYNC;
+    }
+    if (hdr->type == MB_STREAM_DELTA && !s->valid) {
+        return false;
+    }
+
+    const bool had_data = s->valid;
+    const mb_memory_contents_t prev = s->snap;
+    if (!mb_stream_apply(&s->rx, &s->snap)) {
+        return false;
+    }
+    s->valid = true;
+    s->timestamp_ns = hdr->timestamp_ns;
+    board_update(s, had_data ? &prev : NULL);
+    return true;
+}
+
+static void source_read(source_t* s)
+{
+    int ret;
+    while ((ret = mb_stream_recv(&s->rx, s->fd)) > 0) {
+        const bool ok = source_message(s);
+        mb_stream_rx_init(&s->rx);
+        if (!ok) {
+            fprintf(stderr, "%s: protocol error\n", s->path);
+            source_lost(s);
+            return;
+        }
+    }
+    if (ret < 0) {
+        source_lost(s);
+    }
+}
+
+static void source_connect(source_t* s)
+{
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    strncpy(addr.sun_path, s->path, sizeof(addr.sun_path) - 1);
+
+    s->fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (s->fd < 0) {
+        perror("socket");
+        return;
+    }
+    if (connect(s->fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        close(s->fd);
+        s->fd = -1;
+        return;
+    }
+    fcntl(s->fd, F_SETFL, O_NONBLOCK);
+    mb_stream_rx_init(&s->rx);
+    fprintf(stderr, "%s: connected\n", s->path);
+}
+
+static void source_load_image(source_t* s, const struct stat* st)
+{
+    if (st->st_mtim.tv_sec == s->mtime.tv_sec && st->st_mtim.tv_nsec == s->mtime.tv_nsec) {
+        return;
+    }
+
+    mb_memory_contents_t snap;
+    FILE* f = fopen(s->path, "rb");
+    const bool ok = f && fread(&snap, sizeof(snap), 1, f) == 1;
+    if (f) {
+        fclose(f);
+    }
+    if (!ok) {
+        fprintf(stderr, "%s: not a mailbox image\n", s->path);
+        source_lost(s);
+        s->mtime = st->st_mtim;  // Don't retry until it changes
+        return;
+    }
+
+    const bool had_data = s->valid;
+    const mb_memory_contents_t prev = s->snap;
+    s->snap = snap;
+    s->valid = true;
+    s->mtime = st->st_mtim;
+    s->timestamp_ns = timespec_ns(&st->st_mtim);
+    board_update(s, had_data ? &prev : NULL);
+}
+
+// (Re)connect stream sources, reload changed image files
+static void scan_sources(void)
+{
+    for (size_t i = 0; i < num_sources; i++) {
+        source_t* s = &sources[i];
+        if (s->fd >= 0) {
+            continue;
+        }
+
+        struct stat st;
+        if (stat(s->path, &st) < 0) {
+            source_lost(s);
+        } else if (S_ISSOCK(st.st_mode)) {
+            source_connect(s);
+        } else {
+            source_load_image(s, &st);
+        }
+    }
+}
+
+// Send the whole crate view to a new client
+static bool send_view(int fd)
+{
+    for (size_t i = 0; i < num_sources; i++) {
+        const source_t* s = &sources[i];
+        if (s->published && !mb_stream_send_snapshot(fd, s->timestamp_ns, NULL, &s->snap)) {
+            return false;
+        }
+    }
+    const mb_stream_hdr_t sync = {
+        .magic = MB_STREAM_MAGIC,
+        .type = MB_STREAM_SYNC,
+    };
+    return mb_stream_send(fd, &sync, NULL);
+}
+
+static void accept_clients(int listen_fd)
+{
+    for (int fd; (fd = accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC | SOCK_NONBLOCK)) >= 0;) {
+        size_t i = 0;
+        while (i < MAX_CLIENTS && clients[i] >= 0) {
+            i++;
+        }
+        if (i == MAX_CLIENTS || !send_view(fd)) {
+            close(fd);
+            continue;
+        }
+        clients[i] = fd;
+    }
+}
+
+static int listen_socket(const char* path)
+{
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Socket path %s too long\n", path);
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        perror("socket");
+        return -1;
+    }
+    unlink(path);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(fd, MAX_CLIENTS) < 0) {
+        fprintf(stderr, "Could not listen on %s: %s\n", path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static int collect(const char* socket_path)
+{
+    const int listen_fd = listen_socket(socket_path);
+    if (listen_fd < 0) {
+        return 1;
+    }
+    for (size_t i = 0; i < MAX_CLIENTS; i++) {
+        clients[i] = -1;
+    }
+
+    struct sigaction action = {
+        .sa_handler = sig_handler,
+    };
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    struct timespec now, next_scan = {0};
+    while (!terminate) {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (timespec_ns(&now) >= timespec_ns(&next_scan)) {
+            scan_sources();
+            next_scan = now;
+            next_scan.tv_sec += SCAN_INTERVAL_MS / 1000;
+        }
+
+        // Listening socket, stream sources, clients (for hang-up detection)
+        struct pollfd pfd[1 + MAX_SOURCES + MAX_CLIENTS];
+        size_t n = 0;
+        pfd[n++] = (struct pollfd){.fd = listen_fd, .events = POLLIN};
+        for (size_t i = 0; i < num_sources; i++) {
+            pfd[n++] = (struct pollfd){.fd = sources[i].fd, .events = POLLIN};
+        }
+        for (size_t i = 0; i < MAX_CLIENTS; i++) {
+            pfd[n++] = (struct pollfd){.fd = clients[i], .events = POLLIN};
+        }
+
+        const int timeout_ms = (timespec_ns(&next_scan) - timespec_ns(&now)) / 1000000 + 1;
+        if (poll(pfd, n, timeout_ms) <= 0) {
+            continue;
+        }
+
+        if (pfd[0].revents) {
+            accept_clients(listen_fd);
+        }
+        for (size_t i = 0; i < num_sources; i++) {
+            if (pfd[1 + i].revents && sources[i].fd >= 0) {
+                source_read(&sources[i]);
+            }
+        }
+        for (size_t i = 0; i < MAX_CLIENTS; i++) {
+            // Clients don't send anything, so readable means closed
+            if (pfd[1 + num_sources + i].revents && clients[i] >= 0) {
+                drop_client(i);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < MAX_CLIENTS; i++) {
+        if (clients[i] >= 0) {
+            drop_client(i);
+        }
+    }
+    close(listen_fd);
+    unlink(socket_path);
+    return 0;
+}
+
+/* Query mode: print the crate view of a running collector */
+
+typedef struct board {
+    bool used;
+    uint8_t amc_slot_nr;
+    uint8_t ipmb_addr;
+    uint64_t timestamp_ns;
+    mb_memory_contents_t snap;
+} board_t;
+
+static int cmp_board(const void* a, const void* b)
+{
+    const board_t* x = a;
+    const board_t* y = b;
+    if (x->used != y->used) {
+        return x->used ? -1 : 1;
+    }
+    return (int)x->amc_slot_nr - (int)y->amc_slot_nr;
+}
+
+static int query(const char* socket_path)
+{
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    strncpy(addr.sun_path, socket_path, sizeof(addr.sun_path) - 1);
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        fprintf(stderr, "Could not connect to %s: %s\n", socket_path, strerror(errno));
+        return 1;
+    }
+
+    static board_t boards[MAX_SOURCES];
+    static mb_stream_rx_t rx;
+    bool synced = false;
+    mb_stream_rx_init(&rx);
+
+    while (!synced && mb_stream_recv(&rx, fd) > 0) {
+        if (rx.hdr.type == MB_STREAM_SYNC) {
+            synced = true;
+        } else if (rx.hdr.type == MB_STREAM_KEYFRAME) {
+            size_t i = 0;
+            while (i < MAX_SOURCES && boards[i].used) {
+                i++;
+            }
+            if (i < MAX_SOURCES && mb_stream_apply(&rx, &boards[i].snap)) {
+                boards[i].used = true;
+                boards[i].amc_slot_nr = rx.hdr.amc_slot_nr;
+                boards[i].ipmb_addr = rx.hdr.ipmb_addr;
+                boards[i].timestamp_ns = rx.hdr.timestamp_ns;
+            }
+        }
+        mb_stream_rx_init(&rx);
+    }
+    close(fd);
+    if (!synced) {
+        fprintf(stderr, "Could not read crate view from %s\n", socket_path);
+        return 1;
+    }
+
+    qsort(boards, MAX_SOURCES, sizeof(boards[0]), cmp_board);
+
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    const size_t name_len = sizeof(boards[0].snap.mmc_information.board_name);
+    printf("%-4s  %-4s  %-*s  %-10s  %s\n",
+           "Slot",
+           "IPMB",
+           (int)name_len,
+           "Board",
+           "Uptime",
+           "Age");
+    for (size_t i = 0; i < MAX_SOURCES && boards[i].used; i++) {
+        const board_t* b = &boards[i];
+        printf("%4u  0x%02x  %-*.*s  %8u s  %.1f s\n",
+               b->amc_slot_nr,
+               b->ipmb_addr,
+               (int)name_len,
+               (int)name_len,
+               b->snap.mmc_information.board_name,
+               b->snap.mmc_information.mmc_uptime,
+               (double)(timespec_ns(&now) - b->timestamp_ns) / NS_PER_SEC);
+    }
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    const char* socket_path = DEFAULT_SOCKET;
+    bool do_query = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "l:q")) != -1) {
+        switch (opt) {
+            case 'l':
+                socket_path = optarg;
+                break;
+            case 'q':
+                do_query = true;
+                break;
+            default:
+                goto usage;
+        }
+    }
+
+    if (do_query) {
+        if (optind != argc) {
+            goto usage;
+        }
+        return query(socket_path);
+    }
+
+    if (optind == argc || argc - optind > MAX_SOURCES) {
+        goto usage;
+    }
+    for (int i = optind; i < argc; i++) {
+        sources[num_sources++] = (source_t){
+            .path = argv[i],
+            .fd = -1,
+        };
+    }
+    return collect(socket_path);
+
+usage:
+    fprintf(stderr,
+            "usage: %s [-l socket] source...   (source: mmcctrld socket or mailbox image)\r\n"
+            "       %s [-l socket] -q\r\n",
+            argv[0],
+            argv[0]);
+    return 1;
+}
@@ -10,11 +10,16 @@
  *                                                                         *
  ***************************************************************************/
 
+#define _GNU_SOURCE  // accept4()
+
 #include <errno.h>
 #include <ifaddrs.h>
 #include <net/if.h>
 #include <netinet/in.h>
+#include <pthread.h>
+#include <semaphore.h>
 #include <signal.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -22,7 +27,9 @@
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
 #include <sys/types.h>
+#include <sys/un.h>
 #include <syslog.h>
 #include <time.h>
 #include <unistd.h>
@@ -31,13 +38,53 @@
 #include <systemd/sd-daemon.h>
 #endif
 
+#include "mmcctrld_action.h"
+#include "mmcctrld_pipeline.h"
 #include "mmcmb/fpga_mailbox_layout.h"
 #include "mmcmb/mmcmb.h"
+#include "mmcmb/mmcmb_archive.h"
+#include "mmcmb/mmcmb_freshness.h"
+#include "mmcmb/mmcmb_stream.h"
 
 // Poll FPGA control register 4 times per second.
 #define POLL_INTERVAL_MS 250
 
-static bool terminate = false;
+// Telemetry reads for the consumers, at most once per second (MMC update rate): a full
+// snapshot if the archive or stream is enabled, otherwise only the MMC information
+#define SNAPSHOT_INTERVAL_MS 1000
+
+// Telemetry reads only start if they are expected to finish this long before the next poll
+#define TELEMETRY_MARGIN_MS 10
+
+// Check the backplane NIC addresses once per second
+#define NIC_INTERVAL_MS 1000
+
+// History archive: keyframe every minute
+#define ARCHIVE_KEYFRAME_INTERVAL 60
+
+// Snapshot stream subscribers (e.g. mmccrated)
+#define MAX_SUBSCRIBERS 8
+
+#define NS_PER_MS 1000000ull
+#define NS_PER_SEC 1000000000ull
+
+/* Pipeline stages:
+ *
+ * - I/O (main thread): owns the mailbox, polls the FPGA control flags & dispatches
+ *   actions, writes the NIC information, reads snapshots for the telemetry stages
+ * - NIC monitor: looks up the backplane NIC addresses, hands changes to the I/O stage
+ * - Consumers: freshness monitor, history archive and subscriber stream, each on its
+ *   own thread with its own snapshot buffer
+ *
+ * The stages are connected by lock-free, non-blocking primitives, so a slow
+ * getifaddrs() or a blocked consumer can't delay the control path, and a slow archive
+ * write can't delay the other consumers.
+ */
+
+static atomic_bool terminate = false;
+
+static spsc_queue_t nic_queue;  // NIC monitor -> I/O
+static sem_t nic_stop;
 
 static void sigterm_handler(int signum)
 {
@@ -45,10 +92,23 @@ static void sigterm_handler(int signum)
 	sd_notify(0, "STOPPING=1\n");
 #endif
     (void)signum;
-    terminate = true;
+    atomic_store(&terminate, true);
 }
 
 #ifndef ENABLE_SYSTEMD
+static void close_all_fds(void)
+{
+    // With a high RLIMIT_NOFILE, closing the fds one by one takes noticeable time at startup
+#ifdef SYS_close_range
+    if (syscall(SYS_close_range, 0u, ~0u, 0u) == 0) {
+        return;
+    }
+#endif
+    for (int x = sysconf(_SC_OPEN_MAX); x >= 0; x--) {
+        close(x);
+    }
+}
+
 static void daemonize()
 {
     pid_t pid = fork();
@@ -66,8 +126,11 @@ static void daemonize()
     struct sigaction action = {
         .sa_handler = SIG_IGN,
     };
-    sigaction(SIGCHLD, &action, NULL);
     sigaction(SIGHUP, &action, NULL);
+    // Spawned actions are reaped with waitpid() to get their exit status, so SIGCHLD must
+    // not be ignored (the kernel would reap them)
+    action.sa_handler = SIG_DFL;
+    sigaction(SIGCHLD, &action, NULL);
 
     pid = fork();
 
@@ -77,32 +140,151 @@ static void daemonize()
         exit(EXIT_SUCCESS);
     }
 
-    umask(0);
+    // Files created by the daemon (archive, subscriber socket) must not be world-writable
+    umask(022);
 
     if (chdir("/") < 0) {
         perror("chdir");
         exit(EXIT_FAILURE);
     }
 
-    for (int x = sysconf(_SC_OPEN_MAX); x >= 0; x--) {
-        close(x);
-    }
+    close_all_fds();
 
     openlog("mmcctrld", LOG_PID, LOG_DAEMON);
 }
 #endif
 
-void handle_fpga_ctrl(const mb_fpga_ctrl_t* ctrl)
+static void check_freshness(mb_freshness_t* fresh, const snapshot_t* snap)
+{
+    const mb_mmc_information_t info = snap->mb.mmc_information;
+    const uint64_t now = snap->mono_ns;
+    const mb_freshness_state_t prev_state = fresh->state;
+    const mb_freshness_state_t state = snap->full
+                                           ? mb_freshness_update_snapshot(fresh, &snap->mb, now)
+                                           : mb_freshness_update(fresh, info.mmc_uptime, now);
+
+    if (state != prev_state) {
+        switch (state) {
+            case MB_FRESHNESS_STALE:
+                syslog(LOG_WARNING,
+                       "MMC data stale, no update for %llu ms",
+                       (unsigned long long)mb_freshness_age_ms(fresh, now));
+                break;
+            case MB_FRESHNESS_RESTARTED:
+                syslog(LOG_WARNING, "MMC restarted (uptime %u s)", info.mmc_uptime);
+                break;
+            case MB_FRESHNESS_FRESH:
+                if (prev_state == MB_FRESHNESS_STALE) {
+                    syslog(LOG_NOTICE,
+                           "MMC data fresh again (held back: %u, MMC stalls: %u)",
+                           fresh->held_back,
+                           fresh->mmc_stalls);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+#ifdef ENABLE_SYSTEMD
+    sd_notifyf(0,
+               "STATUS=MMC data %s, age %llu ms, %.2f updates/s",
+               mb_freshness_state_str(state),
+               (unsigned long long)mb_freshness_age_ms(fresh, now),
+               fresh->update_rate_hz);
+#endif
+}
+
+/* Snapshot stream subscribers
+ *
+ * Subscribers connect to the Unix socket MMCCTRLD_SOCKET. New subscribers get a keyframe
+ * with the next snapshot, then deltas. A subscriber that can't keep up (socket buffer
+ * full) is dropped, it never blocks the stream thread.
+ */
+
+typedef struct subscribers {
+    int listen_fd;
+    const char* path;
+    int fd[MAX_SUBSCRIBERS];
+    bool synced[MAX_SUBSCRIBERS];  // Got a keyframe, <prev> is valid for it
+    mb_memory_contents_t prev;
+} subscribers_t;
+
+static bool subscribers_open(subscribers_t* subs, const char* path)
+{
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        syslog(LOG_ERR, "Socket path %s too long", path);
+        return false;
+    }
+    strcpy(addr.sun_path, path);
+
+    for (size_t i = 0; i < MAX_SUBSCRIBERS; i++) {
+        subs->fd[i] = -1;
+    }
+    subs->path = path;
+    subs->listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (subs->listen_fd < 0) {
+        syslog(LOG_ERR, "Error: socket(): %s", strerror(errno));
+        return false;
+    }
+    unlink(path);
+    // Subscribers need write permission to connect, restrict them to the owner and group
+    if (bind(subs->listen_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0
+        || chmod(path, 0660) < 0
+        || listen(subs->listen_fd, MAX_SUBSCRIBERS) < 0) {
+        syslog(LOG_ERR, "Could not listen on %s: %s", path, strerror(errno));
+        close(subs->listen_fd);
+        subs->listen_fd = -1;
+        return false;
+    }
+    return true;
+}
+
+static void subscribers_close(subscribers_t* subs)
 {
-    if (!ctrl->req_shutdown) {
+    if (subs->listen_fd < 0) {
         return;
     }
-    syslog(LOG_NOTICE, "Shutdown requested by MMC");
+    for (size_t i = 0; i < MAX_SUBSCRIBERS; i++) {
+        if (subs->fd[i] >= 0) {
+            close(subs->fd[i]);
+        }
+    }
+    close(subs->listen_fd);
+    unlink(subs->path);
+}
 
-    execl("/sbin/shutdown", "shutdown", "-h", "now", (char*)NULL);
+static void subscribers_publish(subscribers_t* subs, const snapshot_t* snap)
+{
+    // Close-on-exec from the start, so spawned actions can't inherit it
+    for (int fd; (fd = accept4(subs->listen_fd, NULL, NULL, SOCK_CLOEXEC | SOCK_NONBLOCK)) >= 0;) {
+        size_t i = 0;
+        while (i < MAX_SUBSCRIBERS && subs->fd[i] >= 0) {
+            i++;
+        }
+        if (i == MAX_SUBSCRIBERS) {
+            syslog(LOG_WARNING, "Too many subscribers, rejecting connection");
+            close(fd);
+            continue;
+        }
+        subs->fd[i] = fd;
+        subs->synced[i] = false;
+    }
 
-    syslog(LOG_ERR, "Could not execute shutdown command: %s", strerror(errno));
-    terminate = true;
+    for (size_t i = 0; i < MAX_SUBSCRIBERS; i++) {
+        if (subs->fd[i] < 0) {
+            continue;
+        }
+        const mb_memory_contents_t* prev = subs->synced[i] ? &subs->prev : NULL;
+        if (mb_stream_send_snapshot(subs->fd[i], snap->real_ns, prev, &snap->mb)) {
+            subs->synced[i] = true;
+        } else {
+            close(subs->fd[i]);
+            subs->fd[i] = -1;
+        }
+    }
+    subs->prev = snap->mb;
 }
 
 mb_nic_information_t get_nic_info(const char* ifname)
@@ -155,8 +337,228 @@ out:
     return result;
 }
 
+static uint64_t timespec_ns(const struct timespec* ts)
+{
+    return ts->tv_sec * NS_PER_SEC + ts->tv_nsec;
+}
+
+static uint64_t clock_ns(clockid_t clk)
+{
+    struct timespec ts;
+    clock_gettime(clk, &ts);
+    return timespec_ns(&ts);
+}
+
+static void timespec_add_ms(struct timespec* ts, unsigned ms)
+{
+    ts->tv_sec += ms / 1000;
+    ts->tv_nsec += (ms % 1000) * NS_PER_MS;
+    if (ts->tv_nsec >= (long)NS_PER_SEC) {
+        ts->tv_sec++;
+        ts->tv_nsec -= NS_PER_SEC;
+    }
+}
+
+static void* nic_monitor_thread(void* arg)
+{
+    const char* ifname = arg;
+    mb_nic_information_t last = {0};
+    bool have_last = false;
+
+    struct timespec next;
+    clock_gettime(CLOCK_REALTIME, &next);
+
+    do {
+        const mb_nic_information_t nic_info = get_nic_info(ifname);
+        if (!have_last || memcmp(&nic_info, &last, sizeof(last))) {
+            // If the queue is full, try again on the next round
+            if (spsc_push(&nic_queue, &nic_info)) {
+                last = nic_info;
+                have_last = true;
+            }
+        }
+        timespec_add_ms(&next, NIC_INTERVAL_MS);
+    } while (sem_timedwait(&nic_stop, &next) < 0 && !atomic_load(&terminate));
+
+    return NULL;
+}
+
+/* Snapshot consumers
+ *
+ * The I/O thread publishes every snapshot to each consumer's triple buffer; a consumer
+ * which falls behind skips snapshots without affecting the others. Full snapshots are
+ * only read while a consumer which needs them is running.
+ */
+
+typedef struct consumer {
+    const char* name;
+    void* (*run)(void* arg);  // Thread function, gets the consumer
+    const char* env;          // Only started if this variable is set, NULL: always
+    bool needs_full;          // Needs full snapshots, not only the MMC information
+    snapshot_buf_t snapshots;
+    pthread_t thread;
+    bool started;
+} consumer_t;
+
+// Wait for the next snapshot, NULL on termination
+static const snapshot_t* consumer_next(consumer_t* c)
+{
+    while (!atomic_load(&terminate)) {
+        snapshot_buf_wait(&c->snapshots);
+        const snapshot_t* snap = snapshot_buf_read(&c->snapshots);
+        if (snap) {
+            return snap;
+        }
+    }
+    return NULL;
+}
+
+static void* freshness_thread(void* arg)
+{
+    consumer_t* c = arg;
+
+    const char* stale_ms = getenv("MMCCTRLD_STALE_MS");
+    mb_freshness_t fresh;
+    mb_freshness_init(&fresh, stale_ms ? strtoul(stale_ms, NULL, 0) : 0);
+
+    for (const snapshot_t* snap; (snap = consumer_next(c));) {
+        check_freshness(&fresh, snap);
+    }
+    return NULL;
+}
+
+static void* archive_thread(void* arg)
+{
+    consumer_t* c = arg;
+
+    const char* archive_path = getenv(c->env);
+    mb_archive_writer_t* archive = mb_archive_create(archive_path, ARCHIVE_KEYFRAME_INTERVAL);
+    if (!archive) {
+        syslog(LOG_ERR, "Could not create history archive %s", archive_path);
+        return NULL;
+    }
+    syslog(LOG_NOTICE, "Recording mailbox history to %s", archive_path);
+
+    for (const snapshot_t* snap; (snap = consumer_next(c));) {
+        if (!mb_archive_append(archive, snap->real_ns, &snap->mb)) {
+            syslog(LOG_ERR, "Could not write history archive, stopped recording");
+            mb_archive_finish(archive);
+            return NULL;
+        }
+    }
+
+    if (!mb_archive_finish(archive)) {
+        syslog(LOG_ERR, "Could not finish history archive");
+    }
+    return NULL;
+}
+
+static void* stream_thread(void* arg)
+{
+    consumer_t* c = arg;
+
+    subscribers_t subs = {.listen_fd = -1};
+    const char* socket_path = getenv(c->env);
+    if (!subscribers_open(&subs, socket_path)) {
+        return NULL;
+    }
+    syslog(LOG_NOTICE, "Streaming snapshots on %s", socket_path);
+
+    for (const snapshot_t* snap; (snap = consumer_next(c));) {
+        subscribers_publish(&subs, snap);
+    }
+
+    subscribers_close(&subs);
+    return NULL;
+}
+
+static consumer_t consumers[] = {
+    {.name = "freshness monitor", .run = freshness_thread},
+    {.name = "history archive",
+     .run = archive_thread,
+     .env = "MMCCTRLD_ARCHIVE",
+     .needs_full = true},
+    {.name = "snapshot stream",
+     .run = stream_thread,
+     .env = "MMCCTRLD_SOCKET",
+     .needs_full = true},
+};
+
+#define NUM_CONSUMERS (sizeof(consumers) / sizeof(consumers[0]))
+
+static bool consumers_start(void)
+{
+    for (size_t i = 0; i < NUM_CONSUMERS; i++) {
+        consumer_t* c = &consumers[i];
+        const char* val = c->env ? getenv(c->env) : NULL;
+        if (c->env && !(val && *val)) {
+            continue;
+        }
+        snapshot_buf_init(&c->snapshots);
+        if (pthread_create(&c->thread, NULL, c->run, c)) {
+            syslog(LOG_ERR, "Could not start %s thread", c->name);
+            snapshot_buf_destroy(&c->snapshots);
+            return false;
+        }
+        c->started = true;
+    }
+    return true;
+}
+
+// True if a running consumer needs full snapshots
+static bool consumers_need_full(void)
+{
+    for (size_t i = 0; i < NUM_CONSUMERS; i++) {
+        if (consumers[i].started && consumers[i].needs_full) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Hand a copy of <snap> to every consumer which can use it
+static void consumers_publish(const snapshot_t* snap)
+{
+    for (size_t i = 0; i < NUM_CONSUMERS; i++) {
+        consumer_t* c = &consumers[i];
+        if (c->started && (snap->full || !c->needs_full)) {
+            *snapshot_buf_back(&c->snapshots) = *snap;
+            snapshot_buf_publish(&c->snapshots);
+        }
+    }
+}
+
+// Call after setting <terminate>
+static void consumers_stop(void)
+{
+    for (size_t i = 0; i < NUM_CONSUMERS; i++) {
+        consumer_t* c = &consumers[i];
+        if (c->started) {
+            snapshot_buf_wake(&c->snapshots);
+            pthread_join(c->thread, NULL);
+            snapshot_buf_destroy(&c->snapshots);
+            c->started = false;
+        }
+    }
+}
+
+// Report the time from the start of the daemon until the MMC was notified
+static void report_ready(uint64_t start_ns)
+{
+    const uint64_t now_ns = clock_ns(CLOCK_MONOTONIC);
+    const double startup_ms = (double)(now_ns - start_ns) / NS_PER_MS;
+    const double boot_s = (double)clock_ns(CLOCK_BOOTTIME) / NS_PER_SEC;
+
+    syslog(LOG_NOTICE, "Startup finished in %.1f ms (%.3f s after boot)", startup_ms, boot_s);
+#ifdef ENABLE_SYSTEMD
+    sd_notifyf(0, "READY=1\nSTATUS=Startup finished in %.1f ms", startup_ms);
+#endif
+}
+
 int main()
 {
+    const uint64_t start_ns = clock_ns(CLOCK_MONOTONIC);
+
     if (geteuid() != 0) {
         fprintf(stderr, "mmcctrld: needs to be launched with root privileges\r\n");
         return EXIT_FAILURE;
@@ -166,6 +568,16 @@ int main()
     daemonize();
 #endif
 
+    // The MMC gates parts of the board management on app_startup_finished, so only the
+    // mailbox discovery and the status write are done before signalling it. The actions,
+    // NIC monitor and telemetry stages are set up afterwards.
+    const char* eeprom_env = getenv("MMCCTRLD_EEPROM");
+    if (eeprom_env && *eeprom_env && !mb_set_eeprom_path(eeprom_env)) {
+        syslog(LOG_ERR, "Invalid mailbox path %s", eeprom_env);
+        goto finish;
+    }
+
+    // Opening the mailbox checks the magic string and version
     const char* eeprom = mb_get_eeprom_path();
     if (eeprom != NULL) {
         syslog(LOG_NOTICE, "Opened mailbox at %s", eeprom);
@@ -173,10 +585,6 @@ int main()
         syslog(LOG_ERR, "Could not open mailbox");
         goto finish;
     }
-    if (!mb_check_magic()) {
-        syslog(LOG_ERR, "Mailbox not available");
-        goto finish;
-    }
 
     const mb_fpga_status_t stat = {
         .app_startup_finished = true,
@@ -185,42 +593,120 @@ int main()
         syslog(LOG_ERR, "Could not set FPGA status");
         goto finish;
     }
+    report_ready(start_ns);
+
+    if (!action_init()) {
+        goto finish;
+    }
 
     const char* bp_eth_ifname = getenv("BP_ETH_IFNAME");
     if (!bp_eth_ifname) {
         bp_eth_ifname = "eth0";
     }
 
-    const struct timespec ts_poll = {
-        .tv_nsec = POLL_INTERVAL_MS * 1e6,
+    if (!spsc_init(&nic_queue, sizeof(mb_nic_information_t), 4)) {
+        syslog(LOG_ERR, "Could not allocate NIC queue");
+        goto finish;
+    }
+    sem_init(&nic_stop, 0, 0);
+
+    struct sigaction action = {
+        .sa_handler = sigterm_handler,
     };
+    sigaction(SIGTERM, &action, NULL);
+
+    // Worker threads inherit a blocked SIGTERM, so it is always handled by the I/O thread
+    sigset_t sigterm_set;
+    sigemptyset(&sigterm_set);
+    sigaddset(&sigterm_set, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &sigterm_set, NULL);
+
+    pthread_t nic_monitor;
+    if (pthread_create(&nic_monitor, NULL, nic_monitor_thread, (void*)bp_eth_ifname) ||
+        !consumers_start()) {
+        syslog(LOG_ERR, "Could not start threads");
+        exit(EXIT_FAILURE);
+    }
+    pthread_sigmask(SIG_UNBLOCK, &sigterm_set, NULL);
 
     syslog(LOG_NOTICE, "Started");
 
-#ifdef ENABLE_SYSTEMD
-    sd_notify(0, "READY=1");
-#endif
+    const bool need_full = consumers_need_full();
+    bool telemetry_pending = false;
+    uint64_t telemetry_est_ns = 0;  // Decaying maximum of the telemetry read time
 
-    struct sigaction action = {
-        .sa_handler = SIG_IGN,
-    };
-    action.sa_handler = sigterm_handler;
-    sigaction(SIGTERM, &action, NULL);
+    mb_nic_information_t nic_info;
+    bool have_nic_info = false;
 
-    while (!terminate) {
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    for (unsigned long n_poll = 0; !atomic_load(&terminate); n_poll++) {
         mb_fpga_ctrl_t ctrl;
         if (!mb_get_fpga_ctrl(&ctrl)) {
             syslog(LOG_ERR, "Could not read FPGA_CTRL");
             break;
         }
-        handle_fpga_ctrl(&ctrl);
+        action_handle_ctrl(&ctrl);
+        if (!action_poll()) {
+            break;
+        }
 
-        mb_nic_information_t nic_info = get_nic_info(bp_eth_ifname);
-        mb_set_bp_eth_info(&nic_info);
+        const bool snapshot_due = n_poll % (SNAPSHOT_INTERVAL_MS / POLL_INTERVAL_MS) == 0;
 
-        nanosleep(&ts_poll, NULL);
+        // Write NIC information on change, and refresh it along with the snapshots
+        bool nic_changed = false;
+        while (spsc_pop(&nic_queue, &nic_info)) {
+            nic_changed = have_nic_info = true;
+        }
+        if (nic_changed || (have_nic_info && snapshot_due)) {
+            mb_set_bp_eth_info(&nic_info);
+        }
+
+        timespec_add_ms(&next, POLL_INTERVAL_MS);
+
+        // The telemetry read holds the bus (and the MMC's page lock), so it is only started
+        // if it is expected to finish before the next fpga_ctrl read is due. Otherwise it is
+        // deferred to the slack after the next poll; a deferral shrinks the estimate, so a
+        // single slow read doesn't stop the telemetry. Due reads never accumulate, the rate
+        // stays capped at one per SNAPSHOT_INTERVAL_MS.
+        telemetry_pending |= snapshot_due;
+        if (telemetry_pending) {
+            const uint64_t start_ns = clock_ns(CLOCK_MONOTONIC);
+            if (start_ns + telemetry_est_ns + TELEMETRY_MARGIN_MS * NS_PER_MS
+                <= timespec_ns(&next)) {
+                snapshot_t snap;
+                snap.full = need_full;
+                if (need_full ? mb_get_snapshot(&snap.mb)
+                              : mb_get_mmc_information(&snap.mb.mmc_information)) {
+                    snap.mono_ns = clock_ns(CLOCK_MONOTONIC);
+                    snap.real_ns = clock_ns(CLOCK_REALTIME);
+                    consumers_publish(&snap);
+                } else {
+                    syslog(LOG_ERR, "Could not read mailbox snapshot");
+                }
+                const uint64_t read_ns = clock_ns(CLOCK_MONOTONIC) - start_ns;
+                telemetry_est_ns -= telemetry_est_ns / 8;
+                if (read_ns > telemetry_est_ns) {
+                    telemetry_est_ns = read_ns;
+                }
+                telemetry_pending = false;
+            } else {
+                telemetry_est_ns -= telemetry_est_ns / 8;
+            }
+        }
+
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
     }
 
+    atomic_store(&terminate, true);
+    sem_post(&nic_stop);
+    pthread_join(nic_monitor, NULL);
+    consumers_stop();
+
+    sem_destroy(&nic_stop);
+    spsc_free(&nic_queue);
+
 finish:
     syslog(LOG_NOTICE, "Terminated");
     closelog();
@@ -0,0 +1,279 @@
+/***************************************************************************
+ *      ____  _____________  __    __  __ _           _____ ___   _        *
+ *     / __ \/ ____/ ___/\ \/ /   |  \/  (_)__ _ _ __|_   _/ __| /_\  (R)  *
+ *    / / / / __/  \__ \  \  /    | |\/| | / _| '_/ _ \| || (__ / _ \      *
+ *   / /_/ / /___ ___/ /  / /     |_|  |_|_\__|_| \___/|_| \___/_/ \_\     *
+ *  /_____/_____//____/  /_/      T  E  C  H  N  O  L  O  G  Y   L A B     *
+ *                                                                         *
+ *          Copyright 2022 Deutsches Elektronen-Synchrotron DESY.          *
+ *                          All rights reserved.                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "mmcctrld_action.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <signal.h>
+#include <spawn.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <syslog.h>
+#include <unistd.h>
+
+#include "mmcmb/fpga_mailbox_layout.h"
+
+#define DEFAULT_SHUTDOWN_CMD "/sbin/shutdown -h now"
+#define DEFAULT_DEBOUNCE 1
+
+#define SYSFS_PCI "/sys/bus/pci"
+#define MAX_CMD_ARGS 16
+
+extern char** environ;
+
+typedef enum action_state {
+    ACTION_IDLE,     // Armed, waiting for the request
+    ACTION_RUNNING,  // Action dispatched
+    ACTION_DONE,     // Action finished, waiting for the request to be deasserted
+} action_state_t;
+
+typedef struct action {
+    const char* name;
+    bool fatal;  // Terminate the daemon if the action fails
+
+    // Handler: either a command to spawn, or a function to run on a worker thread
+    char* argv[MAX_CMD_ARGS + 1];
+    bool (*fn)(const char* arg);
+    const char* arg;
+
+    // Debouncing & edge detection
+    unsigned asserted_cnt;
+    unsigned deasserted_cnt;
+    action_state_t state;
+
+    // Running action
+    pid_t pid;
+    pthread_t thread;
+    atomic_bool thread_done;
+    bool thread_result;
+} action_t;
+
+static char* shutdown_cmd = NULL;
+static unsigned debounce = DEFAULT_DEBOUNCE;
+static bool fatal_error = false;
+
+static action_t act_shutdown = {
+    .name = "Shutdown",
+    .fatal = true,
+};
+
+static action_t act_pcie_reset = {
+    .name = "PCIe reset",
+};
+
+static bool write_sysfs(const char* path, const char* val)
+{
+    int fd = open(path, O_WRONLY | O_CLOEXEC);
+    if (fd < 0) {
+        syslog(LOG_ERR, "Could not open %s: %s", path, strerror(errno));
+        return false;
+    }
+    const ssize_t len = strlen(val);
+    const bool ok = write(fd, val, len) == len;
+    if (!ok) {
+        syslog(LOG_ERR, "Could not write %s: %s", path, strerror(errno));
+    }
+    close(fd);
+    return ok;
+}
+
+static bool pcie_remove_rescan(const char* dev)
+{
+    char path[80 + NAME_MAX];
+    snprintf(path, sizeof(path), SYSFS_PCI "/devices/%s/remove", dev);
+
+    // The device is already gone if a previous rescan did not bring it back, rescan anyway
+    if (access(path, F_OK) == 0 && !write_sysfs(path, "1")) {
+        return false;
+    }
+    return write_sysfs(SYSFS_PCI "/rescan", "1");
+}
+
+// Split a command line into arguments (no quoting), modifies <cmd>
+static bool split_cmd(char* cmd, char** argv)
+{
+    size_t argc = 0;
+    for (char* tok = strtok(cmd, " \t"); tok; tok = strtok(NULL, " \t")) {
+        if (argc == MAX_CMD_ARGS) {
+            return false;
+        }
+        argv[argc++] = tok;
+    }
+    argv[argc] = NULL;
+    return argc > 0;
+}
+
+bool action_init(void)
+{
+    const char* cmd = getenv("MMCCTRLD_SHUTDOWN_CMD");
+    if (!cmd) {
+        cmd = DEFAULT_SHUTDOWN_CMD;
+    }
+    shutdown_cmd = strdup(cmd);
+    if (!shutdown_cmd || !split_cmd(shutdown_cmd, act_shutdown.argv)) {
+        syslog(LOG_ERR, "Invalid shutdown command '%s'", cmd);
+        return false;
+    }
+
+    const char* pcie_dev = getenv("MMCCTRLD_PCIE_DEVICE");
+    if (pcie_dev && *pcie_dev) {
+        act_pcie_reset.fn = pcie_remove_rescan;
+        act_pcie_reset.arg = pcie_dev;
+    }
+
+    const char* deb = getenv("MMCCTRLD_DEBOUNCE");
+    if (deb) {
+        debounce = strtoul(deb, NULL, 0);
+        if (debounce < 1) {
+            debounce = 1;
+        }
+    }
+    return true;
+}
+
+static bool spawn_action(action_t* act)
+{
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+
+    // Don't pass on the daemon's ignored signals (see daemonize())
+    sigset_t sig_default;
+    sigemptyset(&sig_default);
+    sigaddset(&sig_default, SIGHUP);
+    posix_spawnattr_setsigdefault(&attr, &sig_default);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGDEF);
+
+    // Commands without a path are looked up in PATH, like system() did
+    const int err = posix_spawnp(&act->pid, act->argv[0], NULL, &attr, act->argv, environ);
+    posix_spawnattr_destroy(&attr);
+    if (err) {
+        syslog(LOG_ERR, "Could not execute '%s': %s", act->argv[0], strerror(err));
+        return false;
+    }
+    return true;
+}
+
+static void* thread_action(void* arg)
+{
+    action_t* act = arg;
+    act->thread_result = act->fn(act->arg);
+    atomic_store(&act->thread_done, true);
+    return NULL;
+}
+
+static bool dispatch(action_t* act)
+{
+    syslog(LOG_NOTICE, "%s requested by MMC", act->name);
+
+    if (act->argv[0]) {
+        return spawn_action(act);
+    }
+    if (act->fn) {
+        atomic_store(&act->thread_done, false);
+        const int err = pthread_create(&act->thread, NULL, thread_action, act);
+        if (err) {
+            syslog(LOG_ERR, "Could not start %s thread: %s", act->name, strerror(err));
+            return false;
+        }
+        return true;
+    }
+    syslog(LOG_WARNING, "%s not configured, ignoring request", act->name);
+    return false;
+}
+
+static void handle_request(action_t* act, bool req)
+{
+    if (req) {
+        act->deasserted_cnt = 0;
+        if (act->asserted_cnt < debounce) {
+            act->asserted_cnt++;
+        }
+    } else {
+        act->asserted_cnt = 0;
+        if (act->deasserted_cnt < debounce) {
+            act->deasserted_cnt++;
+        }
+    }
+
+    if (act->state == ACTION_IDLE && act->asserted_cnt == debounce) {
+        if (dispatch(act)) {
+            act->state = ACTION_RUNNING;
+        } else {
+            act->state = ACTION_DONE;
+            fatal_error |= act->fatal;
+        }
+    } else if (act->state == ACTION_DONE && act->deasserted_cnt == debounce) {
+        act->state = ACTION_IDLE;
+    }
+}
+
+void action_handle_ctrl(const mb_fpga_ctrl_t* ctrl)
+{
+    handle_request(&act_shutdown, ctrl->req_shutdown);
+    handle_request(&act_pcie_reset, ctrl->req_pcie_reset);
+}
+
+// Returns true if the action finished, sets <ok> to its result
+static bool reap(action_t* act, bool* ok)
+{
+    if (act->argv[0]) {
+        int status;
+        const pid_t pid = waitpid(act->pid, &status, WNOHANG);
+        if (pid == 0) {
+            return false;
+        }
+        if (pid < 0) {
+            // Exit status lost, don't report the action as done
+            syslog(LOG_ERR, "Could not get exit status of '%s': %s", act->argv[0], strerror(errno));
+            *ok = false;
+        } else {
+            *ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        }
+        return true;
+    }
+    if (!atomic_load(&act->thread_done)) {
+        return false;
+    }
+    pthread_join(act->thread, NULL);
+    *ok = act->thread_result;
+    return true;
+}
+
+static bool poll_action(action_t* act)
+{
+    bool ok;
+    if (act->state != ACTION_RUNNING || !reap(act, &ok)) {
+        return true;
+    }
+    act->state = ACTION_DONE;
+    if (ok) {
+        syslog(LOG_NOTICE, "%s action finished", act->name);
+        return true;
+    }
+    syslog(LOG_ERR, "%s action failed", act->name);
+    return !act->fatal;
+}
+
+bool action_poll(void)
+{
+    fatal_error |= !poll_action(&act_shutdown);
+    fatal_error |= !poll_action(&act_pcie_reset);
+    return !fatal_error;
+}
@@ -0,0 +1,45 @@
+/***************************************************************************
+ *      ____  _____________  __    __  __ _           _____ ___   _        *
+ *     / __ \/ ____/ ___/\ \/ /   |  \/  (_)__ _ _ __|_   _/ __| /_\  (R)  *
+ *    / / / / __/  \__ \  \  /    | |\/| | / _| '_/ _ \| || (__ / _ \      *
+ *   / /_/ / /___ ___/ /  / /     |_|  |_|_\__|_| \___/|_| \___/_/ \_\     *
+ *  /_____/_____//____/  /_/      T  E  C  H  N  O  L  O  G  Y   L A B     *
+ *                                                                         *
+ *          Copyright 2022 Deutsches Elektronen-Synchrotron DESY.          *
+ *                          All rights reserved.                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdbool.h>
+
+#include "mmcmb/fpga_mailbox_layout.h"
+
+/* mmcctrld action executor
+ *
+ * Maps the FPGA control request flags to actions. A request triggers its action once
+ * it has been asserted for a number of consecutive polls (debouncing), and only on the
+ * rising edge; it is re-armed once the request has been deasserted again.
+ *
+ * Actions run asynchronously (spawned process or worker thread), so the poll loop
+ * stays responsive while e.g. the shutdown command is running.
+ *
+ * Configuration (environment):
+ *   MMCCTRLD_SHUTDOWN_CMD   Shutdown command (default "/sbin/shutdown -h now")
+ *   MMCCTRLD_PCIE_DEVICE    PCI device to remove & rescan on PCIe reset request,
+ *                           e.g. "0000:01:00.0" (default: PCIe reset requests are ignored)
+ *   MMCCTRLD_DEBOUNCE       Number of consecutive polls a request must be asserted (default 1)
+ *
+ * The daemon never writes fpga_status after the startup, so app_shutdown_finished is
+ * left to the mailbox driver's power-off hook at the very end of the system shutdown.
+ */
+
+// Read the action configuration, returns false on error
+bool action_init(void);
+
+// Evaluate the FPGA control flags and dispatch actions, called on every poll
+void action_handle_ctrl(const mb_fpga_ctrl_t* ctrl);
+
+// Reap finished actions. Returns false if an action failed and the daemon should terminate.
+bool action_poll(void);
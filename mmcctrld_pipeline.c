@@ -0,0 +1,130 @@
+/***************************************************************************
+ *      ____  _____________  __    __  __ _           _____ ___   _        *
+ *     / __ \/ ____/ ___/\ \/ /   |  \/  (_)__ _ _ __|_   _/ __| /_\  (R)  *
+ *    / / / / __/  \__ \  \  /    | |\/| | / _| '_/ _ \| || (__ / _ \      *
+ *   / /_/ / /___ ___/ /  / /     |_|  |_|_\__|_| \___/|_| \___/_/ \_\     *
+ *  /_____/_____//____/  /_/      T  E  C  H  N  O  L  O  G  Y   L A B     *
+ *                                                                         *
+ *          Copyright 2022 Deutsches Elektronen-Synchrotron DESY.          *
+ *                          All rights reserved.                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "mmcctrld_pipeline.h"
+
+#include <errno.h>
+#include <semaphore.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SNAPSHOT_FRESH 0x4u
+#define SNAPSHOT_INDEX 0x3u
+
+/* Bounded single-producer single-consumer queue */
+
+bool spsc_init(spsc_queue_t* q, size_t elem_size, size_t capacity)
+{
+    size_t cap = 1;
+    while (cap < capacity) {
+        cap <<= 1;
+    }
+    q->buf = calloc(cap, elem_size);
+    if (!q->buf) {
+        return false;
+    }
+    q->elem_size = elem_size;
+    q->capacity = cap;
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+    return true;
+}
+
+void spsc_free(spsc_queue_t* q)
+{
+    free(q->buf);
+    q->buf = NULL;
+}
+
+bool spsc_push(spsc_queue_t* q, const void* elem)
+{
+    const size_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    const size_t tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+    if (head - tail == q->capacity) {
+        return false;
+    }
+    memcpy(&q->buf[(head & (q->capacity - 1)) * q->elem_size], elem, q->elem_size);
+    atomic_store_explicit(&q->head, head + 1, memory_order_release);
+    return true;
+}
+
+bool spsc_pop(spsc_queue_t* q, void* elem)
+{
+    const size_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    const size_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+    if (head == tail) {
+        return false;
+    }
+    memcpy(elem, &q->buf[(tail & (q->capacity - 1)) * q->elem_size], q->elem_size);
+    atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+/* Latest-snapshot hand-off (triple buffer) */
+
+void snapshot_buf_init(snapshot_buf_t* sb)
+{
+    memset(sb->bufs, 0, sizeof(sb->bufs));
+    sb->back = 0;
+    atomic_init(&sb->state, 1);
+    sb->front = 2;
+    sem_init(&sb->published, 0, 0);
+}
+
+void snapshot_buf_destroy(snapshot_buf_t* sb)
+{
+    sem_destroy(&sb->published);
+}
+
+snapshot_t* snapshot_buf_back(snapshot_buf_t* sb)
+{
+    return &sb->bufs[sb->back];
+}
+
+void snapshot_buf_publish(snapshot_buf_t* sb)
+{
+    const unsigned prev = atomic_exchange_explicit(&sb->state,
+                                                   sb->back | SNAPSHOT_FRESH,
+                                                   memory_order_acq_rel);
+    sb->back = prev & SNAPSHOT_INDEX;
+    snapshot_buf_wake(sb);
+}
+
+void snapshot_buf_wake(snapshot_buf_t* sb)
+{
+    // Don't let the semaphore count up if the consumer is behind, one wake-up is enough
+    int val;
+    if (sem_getvalue(&sb->published, &val) == 0 && val > 0) {
+        return;
+    }
+    sem_post(&sb->published);
+}
+
+void snapshot_buf_wait(snapshot_buf_t* sb)
+{
+    while (sem_wait(&sb->published) < 0 && errno == EINTR) {
+    }
+}
+
+const snapshot_t* snapshot_buf_read(snapshot_buf_t* sb)
+{
+    if (!(atomic_load_explicit(&sb->state, memory_order_acquire) & SNAPSHOT_FRESH)) {
+        return NULL;
+    }
+    const unsigned prev = atomic_exchange_explicit(&sb->state, sb->front, memory_order_acq_rel);
+    sb->front = prev & SNAPSHOT_INDEX;
+    return &sb->bufs[sb->front];
+}
@@ -0,0 +1,87 @@
+/***************************************************************************
+ *      ____  _____________  __    __  __ _           _____ ___   _        *
+ *     / __ \/ ____/ ___/\ \/ /   |  \/  (_)__ _ _ __|_   _/ __| /_\  (R)  *
+ *    / / / / __/  \__ \  \  /    | |\/| | / _| '_/ _ \| || (__ / _ \      *
+ *   / /_/ / /___ ___/ /  / /     |_|  |_|_\__|_| \___/|_| \___/_/ \_\     *
+ *  /_____/_____//____/  /_/      T  E  C  H  N  O  L  O  G  Y   L A B     *
+ *                                                                         *
+ *          Copyright 2022 Deutsches Elektronen-Synchrotron DESY.          *
+ *                          All rights reserved.                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#pragma once
+
+#include <semaphore.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "mmcmb/fpga_mailbox_layout.h"
+
+/* Lock-free hand-off between the mmcctrld pipeline stages
+ *
+ * Neither primitive ever blocks the producer, so a slow consumer can't delay the
+ * control path in the I/O thread.
+ */
+
+/* Bounded single-producer single-consumer queue */
+
+typedef struct spsc_queue {
+    uint8_t* buf;
+    size_t elem_size;
+    size_t capacity;     // Power of two
+    atomic_size_t head;  // Written by the producer
+    atomic_size_t tail;  // Written by the consumer
+} spsc_queue_t;
+
+// Allocate a queue for <capacity> (rounded up to a power of two) elements of <elem_size> bytes
+bool spsc_init(spsc_queue_t* q, size_t elem_size, size_t capacity);
+void spsc_free(spsc_queue_t* q);
+
+// Returns false if the queue is full
+bool spsc_push(spsc_queue_t* q, const void* elem);
+
+// Returns false if the queue is empty
+bool spsc_pop(spsc_queue_t* q, void* elem);
+
+/* Latest-snapshot hand-off (triple buffer)
+ *
+ * The producer always has a buffer to write to, the consumer always reads the most
+ * recently published snapshot; intermediate snapshots are skipped if the consumer
+ * falls behind.
+ */
+
+typedef struct snapshot {
+    uint64_t mono_ns;  // CLOCK_MONOTONIC time of the read
+    uint64_t real_ns;  // CLOCK_REALTIME time of the read
+    bool full;         // false: only mb.mmc_information was read
+    mb_memory_contents_t mb;
+} snapshot_t;
+
+typedef struct snapshot_buf {
+    snapshot_t bufs[3];
+    atomic_uint state;  // Index of the middle buffer | SNAPSHOT_FRESH
+    unsigned back;      // Producer's buffer
+    unsigned front;     // Consumer's buffer
+    sem_t published;
+} snapshot_buf_t;
+
+void snapshot_buf_init(snapshot_buf_t* sb);
+void snapshot_buf_destroy(snapshot_buf_t* sb);
+
+// Producer: get the buffer to write the next snapshot to
+snapshot_t* snapshot_buf_back(snapshot_buf_t* sb);
+
+// Producer: publish the back buffer and wake up the consumer
+void snapshot_buf_publish(snapshot_buf_t* sb);
+
+// Consumer: wait for a snapshot to be published (or snapshot_buf_wake() to be called)
+void snapshot_buf_wait(snapshot_buf_t* sb);
+
+// Wake up the consumer without publishing, e.g. for termination
+void snapshot_buf_wake(snapshot_buf_t* sb);
+
+// Consumer: get the latest published snapshot, NULL if there is none since the last call
+const snapshot_t* snapshot_buf_read(snapshot_buf_t* sb);
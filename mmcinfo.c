@@ -10,6 +10,7 @@
  *                                                                         *
  ***************************************************************************/
 
+#include <errno.h>
 #include <fcntl.h>
 #include <stdbool.h>
 #include <stddef.h>
@@ -20,6 +21,8 @@
 #include <unistd.h>
 
 #include "mmcmb/mmcmb.h"
+#include "mmcmb/mmcmb_appdata.h"
+#include "mmcmb/mmcmb_validate.h"
 
 static char* uptime_format(uint32_t t, char* buf, size_t len)
 {
@@ -55,17 +58,14 @@ static char* uptime_format(uint32_t t, char* buf, size_t len)
     return buf;
 }
 
-static void dump_str(const char* desc, int rjust, const char* str, int maxlen)
+static void dump_str(const char* desc, int rjust, const char* str, int maxlen, bool valid)
 {
-    printf("%-*s: %.*s\n", rjust, desc, maxlen, *str ? str : "N/A");
+    printf("%-*s: %.*s\n", rjust, desc, maxlen, valid && *str ? str : "N/A");
 }
 
-static void dump_mmc_information(void)
+static void dump_mmc_information(const mb_memory_contents_t* mb, const mb_validity_t* v)
 {
-    mb_mmc_information_t info;
-    if (!mb_get_mmc_information(&info)) {
-        exit(1);
-    }
+    const mb_mmc_information_t info = mb->mmc_information;
 
     printf("MMC information\n");
     printf("---------------\n");
@@ -86,7 +86,11 @@ static void dump_mmc_information(void)
     printf("%-16s: Rev. %c\n", "STAMP revision", info.stamp_hw_revision);
     printf("%-16s: %d\n", "AMC slot", info.amc_slot_nr);
     printf("%-16s: 0x%02x\n", "IPMB addr", info.ipmb_addr);
-    dump_str("Board name", 16, info.board_name, sizeof(info.board_name));
+    dump_str("Board name",
+             16,
+             info.board_name,
+             sizeof(info.board_name),
+             mb_is_valid(v, MB_VALID_BOARD_NAME));
     printf("%-16s: 0x%04x\n", "IANA Vendor ID", info.vendor_id);
     printf("%-16s: 0x%04x\n", "IANA Product ID", info.product_id);
 
@@ -101,26 +105,26 @@ static void dump_mmc_information(void)
     printf("%-16s: %s\n", "Uptime", uptime_format(info.mmc_uptime, tmp, sizeof(tmp)));
 }
 
-static void dump_mmc_sensors(void)
+static void dump_mmc_sensors(const mb_memory_contents_t* mb, const mb_validity_t* v)
 {
-    mb_mmc_sensor_t sen[MAX_SENS_MMC];
-    if (!mb_get_mmc_sensors(sen, 0, MAX_SENS_MMC)) {
-        exit(1);
-    }
+    const mb_mmc_sensor_t* sen = mb->mmc_sensor;
 
     printf("MMC sensors\n");
     printf("-----------\n");
     for (size_t i = 0; i < MAX_SENS_MMC && sen[i].name[0]; i++) {
-        printf("%-13.*s: %g\n", (int)sizeof(sen[i].name), sen[i].name, sen[i].reading);
+        if (mb_is_valid(v, MB_VALID_MMC_SENSOR(i))) {
+            printf("%-13.*s: %g\n", (int)sizeof(sen[i].name), sen[i].name, sen[i].reading);
+        } else {
+            printf("%-13.*s: N/A\n", (int)sizeof(sen[i].name), sen[i].name);
+        }
     }
 }
 
-static void dump_fru_description(size_t fru_id)
+static void dump_fru_description(const mb_memory_contents_t* mb,
+                                 const mb_validity_t* v,
+                                 size_t fru_id)
 {
-    mb_fru_description_t desc;
-    if (!mb_get_fru_description(&desc, fru_id)) {
-        exit(1);
-    }
+    const mb_fru_description_t desc = mb->fru_information[fru_id].description;
 
     printf("FRU %zu description\n", fru_id);
     printf("-----------------\n");
@@ -139,19 +143,29 @@ static void dump_fru_description(size_t fru_id)
                  desc.uid[5]);
     }
     printf("%-14s: %s\n", "UID", uid_str);
-    dump_str("Manufacturer", 14, desc.manufacturer, sizeof(desc.manufacturer));
-    dump_str("Product name", 14, desc.product, sizeof(desc.product));
-    dump_str("Part number", 14, desc.part_nr, sizeof(desc.part_nr));
-    dump_str("Serial number", 14, desc.serial_nr, sizeof(desc.serial_nr));
-    dump_str("Version", 14, desc.version, sizeof(desc.version));
+    const struct {
+        const char* name;
+        const char* str;
+        int len;
+    } strs[MB_FRU_NUM_STR] = {
+        [MB_FRU_MANUFACTURER] = {"Manufacturer", desc.manufacturer, sizeof(desc.manufacturer)},
+        [MB_FRU_PRODUCT] = {"Product name", desc.product, sizeof(desc.product)},
+        [MB_FRU_PART_NR] = {"Part number", desc.part_nr, sizeof(desc.part_nr)},
+        [MB_FRU_SERIAL_NR] = {"Serial number", desc.serial_nr, sizeof(desc.serial_nr)},
+        [MB_FRU_VERSION] = {"Version", desc.version, sizeof(desc.version)},
+    };
+    for (size_t i = 0; i < MB_FRU_NUM_STR; i++) {
+        dump_str(strs[i].name,
+                 14,
+                 strs[i].str,
+                 strs[i].len,
+                 mb_is_valid(v, MB_VALID_FRU_STR(fru_id, i)));
+    }
 }
 
-static void dump_fru_status(size_t fru_id)
+static void dump_fru_status(const mb_memory_contents_t* mb, const mb_validity_t* v, size_t fru_id)
 {
-    mb_fru_status_t stat;
-    if (!mb_get_fru_status(&stat, fru_id)) {
-        exit(1);
-    }
+    const mb_fru_status_t stat = mb->fru_information[fru_id].status;
 
     printf("FRU %zu status\n", fru_id);
     printf("-----------------\n");
@@ -172,9 +186,12 @@ static void dump_fru_status(size_t fru_id)
                stat.ext.fmc.pg_m2c ? "asserted" : "deasserted");
     }
 
-    for (size_t i = 0; i < stat.num_temp_sensors; i++) {
-        if (stat.temperature[i] != FRU_TEMP_INVALID) {
-            const float temp = (float)stat.temperature[i] / 100.f;
+    const size_t n_temp = stat.num_temp_sensors < MAX_SENS_PER_FRU ? stat.num_temp_sensors
+                                                                   : MAX_SENS_PER_FRU;
+    for (size_t i = 0; i < n_temp; i++) {
+        if (mb_is_valid(v, MB_VALID_FRU_TEMP(fru_id, i))) {
+            // Temperatures are s16 in 0.01 deg. C increments
+            const float temp = (float)(int16_t)stat.temperature[i] / 100.f;
             printf("Temperature %zu : %g C\n", i + 1, temp);
         } else {
             printf("Temperature %zu : N/A\n", i + 1);
@@ -182,13 +199,32 @@ static void dump_fru_status(size_t fru_id)
     }
 }
 
-static bool fru_present(size_t fru_id)
+static void dump_appdata(const mb_memory_contents_t* mb)
 {
-    mb_fru_status_t stat;
-    if (!mb_get_fru_status(&stat, fru_id)) {
-        exit(1);
+    printf("Application data\n");
+    printf("----------------\n");
+
+    mb_appdata_iter_t it;
+    if (!mb_appdata_iter_init(&it, mb->application_data)) {
+        printf("No record list\n");
+        return;
+    }
+    mb_appdata_rec_t rec;
+    while (mb_appdata_next(&it, &rec)) {
+        printf("Type 0x%02x    :", rec.type);
+        for (size_t i = 0; i < rec.len; i++) {
+            printf(" %02x", rec.value[i]);
+        }
+        printf("\n");
     }
-    return stat.present;
+    if (it.error) {
+        printf("Malformed record at offset %zu\n", it.pos);
+    }
+}
+
+static bool fru_present(const mb_memory_contents_t* mb, size_t fru_id)
+{
+    return mb->fru_information[fru_id].status.present;
 }
 
 typedef struct dump_enable {
@@ -196,35 +232,72 @@ typedef struct dump_enable {
     bool sensors;
     bool fru[NUM_FRUS];
     bool fpga;
+    bool appdata;
 } dump_enable_t;
 
+// Application data is board-specific, only dumped on request
+static const dump_enable_t dump_all = {true, true, {true, true, true, true}, true, false};
+
+// Enable the dump of section <name>, returns false if the name is unknown
+static bool enable_section(dump_enable_t* en, const char* name)
+{
+    const struct {
+        const char* opt;
+        bool* en;
+    } opt_map[] = {
+        {"mmc", &en->mmc},
+        {"sensors", &en->sensors},
+        {"fru0", &en->fru[0]},
+        {"fru1", &en->fru[1]},
+        {"fru2", &en->fru[2]},
+        {"fru3", &en->fru[3]},
+        {"amc", &en->fru[0]},
+        {"rtm", &en->fru[1]},
+        {"fmc1", &en->fru[2]},
+        {"fmc2", &en->fru[3]},
+        {"fpga", &en->fpga},
+        {"appdata", &en->appdata},
+    };
+    for (size_t k = 0; k < (sizeof(opt_map) / sizeof(opt_map[0])); k++) {
+        if (!strcmp(name, opt_map[k].opt)) {
+            *opt_map[k].en = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool lf_first_call = true;
+
 static void lf(void)
 {
-    static bool first_call = true;
-    if (!first_call) {
+    if (!lf_first_call) {
         printf("\n");
     }
-    first_call = false;
+    lf_first_call = false;
 }
 
-static void dump_mmcmb(dump_enable_t en)
+static void dump_mmcmb(const mb_memory_contents_t* mb, dump_enable_t en)
 {
+    mb_validity_t v;
+    mb_validate_snapshot(mb, &v);
+
     if (en.mmc) {
         lf();
-        dump_mmc_information();
+        dump_mmc_information(mb, &v);
     }
     if (en.sensors) {
         lf();
-        dump_mmc_sensors();
+        dump_mmc_sensors(mb, &v);
     }
 
     for (size_t fru_id = 0; fru_id < NUM_FRUS; fru_id++) {
         if (en.fru[fru_id]) {
-            if (fru_present(fru_id)) {
+            if (fru_present(mb, fru_id)) {
                 lf();
-                dump_fru_description(fru_id);
+                dump_fru_description(mb, &v, fru_id);
                 lf();
-                dump_fru_status(fru_id);
+                dump_fru_status(mb, &v, fru_id);
             } else {
                 lf();
                 printf("FRU %zu not present\n", fru_id);
@@ -234,65 +307,284 @@ static void dump_mmcmb(dump_enable_t en)
     }
 
     if (en.fpga) {
-        mb_fpga_ctrl_t ctrl;
-        if (mb_get_fpga_ctrl(&ctrl)) {
-            lf();
-            printf("FPGA Ctrl: %cShdn %cPCIeReset\r\n",
-                   ctrl.req_shutdown ? '+' : '-',
-                   ctrl.req_pcie_reset ? '+' : '-');
+        const mb_fpga_ctrl_t ctrl = mb->fpga_ctrl;
+        lf();
+        printf("FPGA Ctrl: %cShdn %cPCIeReset\r\n",
+               ctrl.req_shutdown ? '+' : '-',
+               ctrl.req_pcie_reset ? '+' : '-');
+    }
+
+    if (en.appdata) {
+        lf();
+        dump_appdata(mb);
+    }
+}
+
+static bool load_image(const char* path, mb_memory_contents_t* mb)
+{
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "Could not open %s: %s\r\n", path, strerror(errno));
+        return false;
+    }
+    // Read one byte more than expected to detect oversized files
+    uint8_t buf[sizeof(*mb) + 1];
+    const size_t n = fread(buf, 1, sizeof(buf), f);
+    fclose(f);
+    if (n != sizeof(*mb)) {
+        fprintf(stderr,
+                "%s: not a mailbox image (%zu bytes, expected %zu)\r\n",
+                path,
+                n,
+                sizeof(*mb));
+        return false;
+    }
+    memcpy(mb, buf, sizeof(*mb));
+    if (memcmp(mb->mailbox_magic_str, MB_MAGIC_STR, sizeof(mb->mailbox_magic_str))) {
+        fprintf(stderr, "%s: mailbox magic string not found\r\n", path);
+        return false;
+    }
+    return true;
+}
+
+static bool save_image(const char* path, const mb_memory_contents_t* mb)
+{
+    FILE* f = fopen(path, "wb");
+    if (!f) {
+        fprintf(stderr, "Could not create %s: %s\r\n", path, strerror(errno));
+        return false;
+    }
+    const bool ok = fwrite(mb, sizeof(*mb), 1, f) == 1;
+    if (fclose(f) || !ok) {
+        fprintf(stderr, "Could not write %s: %s\r\n", path, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+static void format_field(const uint8_t* buf, const mb_field_desc_t* fd, char* str, size_t len)
+{
+    const uint8_t* p = &buf[fd->offs];
+    uint16_t u16;
+    uint32_t u32;
+    float f;
+
+    // Mailbox data is little-endian
+    switch (fd->type) {
+        case MB_FIELD_CHAR:
+            snprintf(str, len, "\"%.*s\"", (int)strnlen((const char*)p, fd->size), (const char*)p);
+            return;
+        case MB_FIELD_U16:
+            u16 = p[0] | p[1] << 8;
+            snprintf(str, len, "%u (0x%04x)", u16, u16);
+            return;
+        case MB_FIELD_S16:
+            u16 = p[0] | p[1] << 8;
+            snprintf(str, len, "%d (0x%04x)", (int16_t)u16, u16);
+            return;
+        case MB_FIELD_U32:
+            u32 = p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+            snprintf(str, len, "%u", u32);
+            return;
+        case MB_FIELD_FLOAT:
+            u32 = p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+            memcpy(&f, &u32, sizeof(f));
+            snprintf(str, len, "%g", f);
+            return;
+        case MB_FIELD_U8:
+            if (fd->size == 1) {
+                snprintf(str, len, "%u", p[0]);
+                return;
+            }
+            break;
+        default:
+            break;
+    }
+    // Raw bytes, bitfields & byte arrays as hex
+    size_t l = 0;
+    for (size_t i = 0; i < fd->size && l + 2 < len; i++) {
+        l += snprintf(str + l, len - l, "%02x", p[i]);
+    }
+}
+
+// Returns 0 if the images are equal, 1 if they differ, 2 on error (as diff(1))
+static int diff_images(const char* path_a, const char* path_b)
+{
+    mb_memory_contents_t a, b;
+    if (!load_image(path_a, &a) || !load_image(path_b, &b)) {
+        return 2;
+    }
+    if (a.mailbox_version != b.mailbox_version) {
+        printf("%-40s: %u -> %u\n", "mailbox_version", a.mailbox_version, b.mailbox_version);
+    }
+
+    size_t n_fields;
+    const mb_field_desc_t* fields = mb_get_fields(a.mailbox_version, &n_fields);
+    if (!fields) {
+        fprintf(stderr, "Unsupported mailbox version %u\r\n", a.mailbox_version);
+        return 2;
+    }
+
+    int differ = memcmp(&a, &b, sizeof(a)) ? 1 : 0;
+    for (size_t i = 0; i < n_fields && differ; i++) {
+        const mb_field_desc_t* fd = &fields[i];
+        if (!memcmp((const uint8_t*)&a + fd->offs, (const uint8_t*)&b + fd->offs, fd->size)) {
+            continue;
+        }
+        char str_a[2 * 256 + 1], str_b[2 * 256 + 1];
+        format_field((const uint8_t*)&a, fd, str_a, sizeof(str_a));
+        format_field((const uint8_t*)&b, fd, str_b, sizeof(str_b));
+        printf("%-40s: %s -> %s\n", fd->name, str_a, str_b);
+    }
+    return differ;
+}
+
+// Read the whole mailbox in one go, either from the EEPROM or from an image file
+static bool get_mailbox(const char* image_in, mb_memory_contents_t* mb)
+{
+    if (image_in) {
+        return load_image(image_in, mb);
+    }
+    if (!mb_get_snapshot(mb) ||
+        memcmp(mb->mailbox_magic_str, MB_MAGIC_STR, sizeof(mb->mailbox_magic_str))) {
+        fprintf(stderr, "Mailbox not available\r\n");
+        return false;
+    }
+    return true;
+}
+
+static void dump_hex(const mb_memory_contents_t* mb)
+{
+    const uint8_t* p = (const uint8_t*)mb;
+    for (size_t i = 0; i < sizeof(*mb); i++) {
+        printf("%02x", p[i]);
+    }
+    printf("\n");
+}
+
+// Answer queries from stdin, one per line, until EOF or "quit".
+// A query is a list of section names, "all" or "snapshot" (raw image as hex).
+// Each query reads a fresh snapshot, each response is terminated by a line containing ".".
+static int batch_mode(const char* image_in)
+{
+    char line[256];
+    while (fgets(line, sizeof(line), stdin)) {
+        dump_enable_t en = {0};
+        bool snapshot = false, empty = true, valid = true;
+
+        for (char* tok = strtok(line, " \t\r\n"); tok; tok = strtok(NULL, " \t\r\n")) {
+            empty = false;
+            if (!strcmp(tok, "quit")) {
+                return 0;
+            } else if (!strcmp(tok, "all")) {
+                en = dump_all;
+            } else if (!strcmp(tok, "snapshot")) {
+                snapshot = true;
+            } else if (!enable_section(&en, tok)) {
+                printf("ERR unknown query '%s'\n", tok);
+                valid = false;
+                break;
+            }
+        }
+        if (empty) {
+            continue;
         }
+
+        mb_memory_contents_t mb;
+        if (valid && get_mailbox(image_in, &mb)) {
+            lf_first_call = true;
+            if (snapshot) {
+                lf();
+                dump_hex(&mb);
+            }
+            dump_mmcmb(&mb, en);
+        } else if (valid) {
+            printf("ERR mailbox not available\n");
+        }
+        printf(".\n");
+        fflush(stdout);
     }
+    return 0;
 }
 
 int main(int argc, char** argv)
 {
+    const char* image_in = NULL;
+    const char* image_out = NULL;
+    bool diff = false;
+    bool batch = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "r:w:db")) != -1) {
+        switch (opt) {
+            case 'r':
+                image_in = optarg;
+                break;
+            case 'w':
+                image_out = optarg;
+                break;
+            case 'd':
+                diff = true;
+                break;
+            case 'b':
+                batch = true;
+                break;
+            default:
+                goto usage;
+        }
+    }
+
+    if (diff) {
+        if (image_in || image_out || batch || argc - optind != 2) {
+            goto usage;
+        }
+        return diff_images(argv[optind], argv[optind + 1]);
+    }
+
+    if (batch) {
+        if (image_out || optind < argc) {
+            goto usage;
+        }
+        return batch_mode(image_in);
+    }
+
     dump_enable_t en = {0};
-    const struct {
-        const char* opt;
-        bool* en;
-    } opt_map[] = {
-        {"mmc", &en.mmc},
-        {"sensors", &en.sensors},
-        {"fru0", &en.fru[0]},
-        {"fru1", &en.fru[1]},
-        {"fru2", &en.fru[2]},
-        {"fru3", &en.fru[3]},
-        {"amc", &en.fru[0]},
-        {"rtm", &en.fru[1]},
-        {"fmc1", &en.fru[2]},
-        {"fmc2", &en.fru[3]},
-        {"fpga", &en.fpga},
-    };
-    if (argc <= 1) {
-        // Dump all
-        en = (dump_enable_t){true, true, {true, true, true, true}, true};
+    if (optind >= argc) {
+        en = dump_all;
     } else {
-        for (int i = 1; i < argc; i++) {
-            bool opt_found = false;
-            for (size_t k = 0; k < (sizeof(opt_map) / sizeof(opt_map[0])); k++) {
-                if (!strcmp(argv[i], opt_map[k].opt)) {
-                    *opt_map[k].en = true;
-                    opt_found = true;
-                    break;
-                }
-            }
-            if (!opt_found) {
+        for (int i = optind; i < argc; i++) {
+            if (!enable_section(&en, argv[i])) {
                 goto usage;
             }
         }
     }
 
-    if (!mb_check_magic()) {
-        fprintf(stderr, "Mailbox not available\r\n");
+    mb_memory_contents_t mb;
+    if (!get_mailbox(image_in, &mb)) {
         return 1;
     }
 
-    dump_mmcmb(en);
+    if (image_out) {
+        if (!save_image(image_out, &mb)) {
+            return 1;
+        }
+        // When saving an image, only dump the sections explicitly asked for
+        if (optind >= argc) {
+            return 0;
+        }
+    }
+
+    dump_mmcmb(&mb, en);
     return 0;
 
 usage:
     fprintf(stderr,
-            "usage: %s [mmc] [sensors] [fru0..3] [amc] [rtm] [fmc1] [fmc2] [fpga]\r\n",
+            "usage: %s [-r image] [-w image] "
+            "[mmc] [sensors] [fru0..3] [amc] [rtm] [fmc1] [fmc2] [fpga] [appdata]\r\n"
+            "       %s -d image_a image_b\r\n"
+            "       %s -b [-r image]\r\n",
+            argv[0],
+            argv[0],
             argv[0]);
     return 1;
 }
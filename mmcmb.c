@@ -17,9 +17,11 @@
 #include <fcntl.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "mmcmb/fpga_mailbox_layout.h"
@@ -41,6 +43,25 @@ static char eeprom_path[290] = {0};
 static int fd_rdonly = -1;
 static int fd_wronly = -1;
 
+// Layout description (generated, see mmcmb_fields.c), selected once from the mailbox
+// version byte at open time
+static const mb_version_desc_t* layout = NULL;
+
+// Opt-in snapshot cache, validity is tracked per 32-byte chunk
+#define CACHE_CHUNK_SIZE 32
+#define CACHE_NUM_CHUNKS ((sizeof(mb_memory_contents_t) + CACHE_CHUNK_SIZE - 1) / CACHE_CHUNK_SIZE)
+#define CACHE_ALL_CHUNKS (~0ull >> (64 - CACHE_NUM_CHUNKS))
+static_assert(CACHE_NUM_CHUNKS <= 64, "Cache chunk bitmap too small");
+
+static struct {
+    bool enabled;
+    uint64_t ttl_ns;
+    uint64_t read_ns;  // Time of the last full read, 0 if none
+    uint64_t valid;    // Bitmap of valid chunks
+    bool patched;      // Chunks were re-read after the full read
+    mb_memory_contents_t mb;
+} cache = {0};
+
 static char* get_compatible_eeprom(const char* dt_compat_id)
 {
     if (eeprom_path[0] != '\0') {
@@ -70,7 +91,7 @@ static char* get_compatible_eeprom(const char* dt_compat_id)
                  SYSFS_DEVICES "/%s/" NODE_COMPATIBLE,
                  dir->d_name);
 
-        int comp_id_fd = open(comp_id_path, O_RDONLY);
+        int comp_id_fd = open(comp_id_path, O_RDONLY | O_CLOEXEC);
         if (comp_id_fd < 0) {
             continue;
         }
@@ -92,9 +113,37 @@ static char* get_compatible_eeprom(const char* dt_compat_id)
     return found ? eeprom_path : NULL;
 }
 
+static bool mb_select_layout(int fd)
+{
+    struct {
+        char magic_str[MB_NUM_ELEMS(mailbox_magic_str)];
+        uint8_t version;
+    } hdr;
+    static_assert(sizeof(hdr) == MB_EEPROM_OFFS(mailbox_version) + 1, "Header size mismatch");
+
+    if (pread(fd, &hdr, sizeof(hdr), 0) != sizeof(hdr)) {
+        perror("read error");
+        return false;
+    }
+    if (memcmp(hdr.magic_str, MB_MAGIC_STR, sizeof(hdr.magic_str))) {
+        // Not a mailbox (yet), don't guess a layout; the next access will retry
+        fprintf(stderr, "Mailbox magic string not found\n");
+        return false;
+    }
+    if ((layout = mb_get_version_desc(hdr.version))) {
+        return true;
+    }
+    fprintf(stderr,
+            "Unsupported mailbox version %u (supported: %u..%u)\n",
+            hdr.version,
+            MB_VERSION_MIN,
+            MB_VERSION_MAX);
+    return false;
+}
+
 static bool mb_open(int* fd, int mode)
 {
-    if (*fd > 0) {
+    if (*fd >= 0) {
         return true;
     }
 
@@ -104,15 +153,21 @@ static bool mb_open(int* fd, int mode)
         return false;
     }
 
-    *fd = open(path, mode);
+    // Keep the mailbox out of processes spawned by the application
+    *fd = open(path, mode | O_CLOEXEC);
     if (*fd < 0) {
         fprintf(stderr, "Could not open %s: %s\n", path, strerror(errno));
         return false;
     }
+    if (mode == O_RDONLY && !mb_select_layout(*fd)) {
+        close(*fd);
+        *fd = -1;
+        return false;
+    }
     return true;
 }
 
-static bool mb_read_at(size_t offs, void* buf, size_t n)
+static bool mb_pread(size_t offs, void* buf, size_t n)
 {
     if (!mb_open(&fd_rdonly, O_RDONLY)) {
         return false;
@@ -126,6 +181,79 @@ static bool mb_read_at(size_t offs, void* buf, size_t n)
     return true;
 }
 
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// Bitmap of the cache chunks covering <n> bytes at <offs>
+static uint64_t cache_chunks(size_t offs, size_t n)
+{
+    if (n == 0) {
+        return 0;
+    }
+    const size_t first = offs / CACHE_CHUNK_SIZE;
+    const size_t last = (offs + n - 1) / CACHE_CHUNK_SIZE;
+    return (~0ull >> (63 - last)) & (~0ull << first);
+}
+
+static bool cache_expired(void)
+{
+    return !cache.read_ns || now_ns() - cache.read_ns >= cache.ttl_ns;
+}
+
+static bool cache_fill(void)
+{
+    cache.valid = 0;
+    if (!mb_pread(0, &cache.mb, sizeof(cache.mb))) {
+        return false;
+    }
+    cache.valid = CACHE_ALL_CHUNKS;
+    cache.patched = false;
+    cache.read_ns = now_ns();
+    return true;
+}
+
+static bool mb_read_at(size_t offs, void* buf, size_t n)
+{
+    if (!cache.enabled) {
+        return mb_pread(offs, buf, n);
+    }
+
+    uint8_t* cached = (uint8_t*)&cache.mb;
+    const size_t ctrl_offs = MB_EEPROM_OFFS(fpga_ctrl);
+
+    if (offs < ctrl_offs + sizeof(mb_fpga_ctrl_t) && offs + n > ctrl_offs) {
+        // The control flags are never served from the cache
+        if (!mb_pread(offs, buf, n)) {
+            return false;
+        }
+        memcpy(&cached[offs], buf, n);
+        return true;
+    }
+
+    if (cache_expired()) {
+        if (!cache_fill()) {
+            return false;
+        }
+    } else if (cache_chunks(offs, n) & ~cache.valid) {
+        // Re-read the invalidated chunks of the range
+        const uint64_t missing = cache_chunks(offs, n) & ~cache.valid;
+        const size_t first = __builtin_ctzll(missing) * CACHE_CHUNK_SIZE;
+        const size_t last = 63 - __builtin_clzll(missing);
+        const size_t end = MIN((last + 1) * CACHE_CHUNK_SIZE, sizeof(cache.mb));
+        if (!mb_pread(first, &cached[first], end - first)) {
+            return false;
+        }
+        cache.valid |= cache_chunks(first, end - first);
+        cache.patched = true;
+    }
+    memcpy(buf, &cached[offs], n);
+    return true;
+}
+
 static bool mb_write_at(size_t offs, const void* buf, size_t n)
 {
     if (!mb_open(&fd_wronly, O_WRONLY)) {
@@ -137,14 +265,62 @@ static bool mb_write_at(size_t offs, const void* buf, size_t n)
         perror("write error");
         return false;
     }
+    if (cache.enabled) {
+        memcpy((uint8_t*)&cache.mb + offs, buf, n);
+    }
     return true;
 }
 
+void mb_cache_enable(unsigned ttl_ms)
+{
+    cache.enabled = true;
+    cache.ttl_ns = (ttl_ms ? ttl_ms : MB_CACHE_DEFAULT_TTL_MS) * 1000000ull;
+    mb_cache_invalidate();
+}
+
+void mb_cache_disable(void)
+{
+    cache.enabled = false;
+    mb_cache_invalidate();
+}
+
+void mb_cache_invalidate(void)
+{
+    cache.valid = 0;
+    cache.read_ns = 0;
+}
+
+void mb_cache_invalidate_range(size_t offs, size_t len)
+{
+    if (offs < sizeof(cache.mb)) {
+        cache.valid &= ~cache_chunks(offs, MIN(len, sizeof(cache.mb) - offs));
+    }
+}
+
+bool mb_cache_refresh(void)
+{
+    return cache.enabled && cache_fill();
+}
+
 const char* mb_get_eeprom_path(void)
 {
     return mb_open(&fd_rdonly, O_RDONLY) ? eeprom_path : NULL;
 }
 
+bool mb_set_eeprom_path(const char* path)
+{
+    if (fd_rdonly >= 0 || fd_wronly >= 0) {
+        fprintf(stderr, "Mailbox already opened at %s\n", eeprom_path);
+        return false;
+    }
+    if (strlen(path) >= sizeof(eeprom_path)) {
+        fprintf(stderr, "Mailbox path too long\n");
+        return false;
+    }
+    strcpy(eeprom_path, path);
+    return true;
+}
+
 bool mb_check_magic(void)
 {
     char magic_str_mb[MB_NUM_ELEMS(mailbox_magic_str)];
@@ -155,9 +331,18 @@ bool mb_check_magic(void)
     return !memcmp(magic_str_mb, MB_MAGIC_STR, sizeof(magic_str_mb));
 }
 
+unsigned mb_get_version(void)
+{
+    return mb_open(&fd_rdonly, O_RDONLY) ? layout->version : 0;
+}
+
 bool mb_get_mmc_information(mb_mmc_information_t* info)
 {
-    return mb_read_at(MB_EEPROM_OFFS(mmc_information), info, sizeof(mb_mmc_information_t));
+    if (!mb_read_at(MB_EEPROM_OFFS(mmc_information), info, sizeof(mb_mmc_information_t))) {
+        return false;
+    }
+    mb_clear_undefined(layout, info, MB_EEPROM_OFFS(mmc_information), sizeof(*info));
+    return true;
 }
 
 bool mb_get_mmc_sensors(mb_mmc_sensor_t* sen, size_t first_sensor, size_t n)
@@ -191,11 +376,29 @@ bool mb_get_fru_status(mb_fru_status_t* stat, size_t fru_id)
                       sizeof(mb_fru_status_t));
 }
 
+bool mb_get_snapshot(mb_memory_contents_t* snap)
+{
+    if (cache.enabled) {
+        // Only serve snapshots from a single read, not patched up ones
+        if ((cache_expired() || cache.valid != CACHE_ALL_CHUNKS || cache.patched)
+            && !cache_fill()) {
+            return false;
+        }
+        *snap = cache.mb;
+    } else if (!mb_pread(0, snap, sizeof(*snap))) {
+        return false;
+    }
+    mb_clear_undefined(layout, snap, 0, sizeof(*snap));
+    return true;
+}
+
 bool mb_get_application_specific_data(void* buf, size_t offs, size_t len)
 {
     const size_t d_size = MB_NUM_ELEMS(application_data);
-    offs = MIN(offs, d_size);
-    len = MIN(len, d_size - offs);
+    if (offs > d_size || len > d_size - offs) {
+        fprintf(stderr, "Application data index out of range (%zu > %zu)\n", offs + len, d_size);
+        return false;
+    }
     return mb_read_at(MB_EEPROM_OFFS(application_data[offs]), buf, len);
 }
 
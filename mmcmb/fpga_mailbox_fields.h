@@ -0,0 +1,412 @@
+/***************************************************************************
+ *      ____  _____________  __    __  __ _           _____ ___   _        *
+ *     / __ \/ ____/ ___/\ \/ /   |  \/  (_)__ _ _ __|_   _/ __| /_\  (R)  *
+ *    / / / / __/  \__ \  \  /    | |\/| | / _| '_/ _ \| || (__ / _ \      *
+ *   / /_/ / /___ ___/ /  / /     |_|  |_|_\__|_| \___/|_| \___/_/ \_\     *
+ *  /_____/_____//____/  /_/      T  E  C  H  N  O  L  O  G  Y   L A B     *
+ *                                                                         *
+ *          Copyright 2022 Deutsches Elektronen-Synchrotron DESY.          *
+ *                          All rights reserved.                           *
+ *                                                                         *
+ ***************************************************************************/
+
+/* Generated from doc/mmc-fpga-data-interface.ods by doc/ods2layout.py, do not edit */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MB_VERSION_MIN 2
+#define MB_VERSION_MAX 3
+
+typedef enum mb_field_type {
+    MB_FIELD_RAW,
+    MB_FIELD_CHAR,
+    MB_FIELD_U8,
+    MB_FIELD_U16,
+    MB_FIELD_S16,
+    MB_FIELD_U32,
+    MB_FIELD_FLOAT,
+    MB_FIELD_BITS,
+} mb_field_type_t;
+
+typedef struct mb_field_desc {
+    const char* name;
+    uint16_t offs;
+    uint16_t size;
+    mb_field_type_t type;
+} mb_field_desc_t;
+
+// Per-version layout description
+typedef struct mb_version_desc {
+    unsigned version;
+    const mb_field_desc_t* fields;
+    size_t num_fields;
+    // Fields of mb_memory_contents_t (latest version) which this version doesn't define
+    const mb_field_desc_t* undefined;
+    size_t num_undefined;
+} mb_version_desc_t;
+
+// Get the layout description of mailbox <version>, returns NULL if the version is unknown
+const mb_version_desc_t* mb_get_version_desc(unsigned version);
+
+// Get the field table of mailbox <version>, returns NULL if the version is unknown
+const mb_field_desc_t* mb_get_fields(unsigned version, size_t* num_fields);
+
+// Zero the fields not defined by <desc> in <buf>, which holds mailbox bytes [offs, offs + len)
+void mb_clear_undefined(const mb_version_desc_t* desc, void* buf, size_t offs, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+/* Check mb_memory_contents_t for consistency with the memory map */
+#if MB_LAYOUT_VERSION != 3
+#error "mb_memory_contents_t does not match the latest documented mailbox version"
+#endif
+
+static_assert(MB_EEPROM_OFFS(mailbox_magic_str) == 0, "Offset of mailbox_magic_str incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mailbox_magic_str) == 7, "Size of mailbox_magic_str incorrect");
+static_assert(MB_EEPROM_OFFS(mailbox_version) == 7, "Offset of mailbox_version incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mailbox_version) == 1, "Size of mailbox_version incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[0].status.num_temp_sensors) == 9, "Offset of fru_information[0].status.num_temp_sensors incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[0].status.num_temp_sensors) == 1, "Size of fru_information[0].status.num_temp_sensors incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[0].status.temperature[0]) == 10, "Offset of fru_information[0].status.temperature[0] incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[0].status.temperature[0]) == 2, "Size of fru_information[0].status.temperature[0] incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[0].status.temperature[1]) == 12, "Offset of fru_information[0].status.temperature[1] incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[0].status.temperature[1]) == 2, "Size of fru_information[0].status.temperature[1] incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[0].status.temperature[2]) == 14, "Offset of fru_information[0].status.temperature[2] incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[0].status.temperature[2]) == 2, "Size of fru_information[0].status.temperature[2] incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[0].status.temperature[3]) == 16, "Offset of fru_information[0].status.temperature[3] incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[0].status.temperature[3]) == 2, "Size of fru_information[0].status.temperature[3] incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[0].status.temperature[4]) == 18, "Offset of fru_information[0].status.temperature[4] incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[0].status.temperature[4]) == 2, "Size of fru_information[0].status.temperature[4] incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[0].status.temperature[5]) == 20, "Offset of fru_information[0].status.temperature[5] incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[0].status.temperature[5]) == 2, "Size of fru_information[0].status.temperature[5] incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[0].status.temperature[6]) == 22, "Offset of fru_information[0].status.temperature[6] incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[0].status.temperature[6]) == 2, "Size of fru_information[0].status.temperature[6] incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[0].status.temperature[7]) == 24, "Offset of fru_information[0].status.temperature[7] incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[0].status.temperature[7]) == 2, "Size of fru_information[0].status.temperature[7] incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[0].status.ext) == 26, "Offset of fru_information[0].status.ext incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[0].status.ext) == 2, "Size of fru_information[0].status.ext incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[0].description.uid) == 28, "Offset of fru_information[0].description.uid incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[0].description.uid) == 6, "Size of fru_information[0].description.uid incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[0].description.manufacturer) == 34, "Offset of fru_information[0].description.manufacturer incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[0].description.manufacturer) == 60, "Size of fru_information[0].description.manufacturer incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[0].description.product) == 94, "Offset of fru_information[0].description.product incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[0].description.product) == 60, "Size of fru_information[0].description.product incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[0].description.part_nr) == 154, "Offset of fru_information[0].description.part_nr incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[0].description.part_nr) == 60, "Size of fru_information[0].description.part_nr incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[0].description.serial_nr) == 214, "Offset of fru_information[0].description.serial_nr incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[0].description.serial_nr) == 30, "Size of fru_information[0].description.serial_nr incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[0].description.version) == 244, "Offset of fru_information[0].description.version incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[0].description.version) == 20, "Size of fru_information[0].description.version incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[1].status.num_temp_sensors) == 265, "Offset of fru_information[1].status.num_temp_sensors incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[1].status.num_temp_sensors) == 1, "Size of fru_information[1].status.num_temp_sensors incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[1].status.temperature[0]) == 266, "Offset of fru_information[1].status.temperature[0] incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[1].status.temperature[0]) == 2, "Size of fru_information[1].status.temperature[0] incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[1].status.temperature[1]) == 268, "Offset of fru_information[1].status.temperature[1] incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[1].status.temperature[1]) == 2, "Size of fru_information[1].status.temperature[1] incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[1].status.temperature[2]) == 270, "Offset of fru_information[1].status.temperature[2] incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[1].status.temperature[2]) == 2, "Size of fru_information[1].status.temperature[2] incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[1].status.temperature[3]) == 272, "Offset of fru_information[1].status.temperature[3] incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[1].status.temperature[3]) == 2, "Size of fru_information[1].status.temperature[3] incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[1].status.temperature[4]) == 274, "Offset of fru_information[1].status.temperature[4] incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[1].status.temperature[4]) == 2, "Size of fru_information[1].status.temperature[4] incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[1].status.temperature[5]) == 276, "Offset of fru_information[1].status.temperature[5] incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[1].status.temperature[5]) == 2, "Size of fru_information[1].status.temperature[5] incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[1].status.temperature[6]) == 278, "Offset of fru_information[1].status.temperature[6] incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[1].status.temperature[6]) == 2, "Size of fru_information[1].status.temperature[6] incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[1].status.temperature[7]) == 280, "Offset of fru_information[1].status.temperature[7] incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[1].status.temperature[7]) == 2, "Size of fru_information[1].status.temperature[7] incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[1].status.ext) == 282, "Offset of fru_information[1].status.ext incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[1].status.ext) == 2, "Size of fru_information[1].status.ext incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[1].description.uid) == 284, "Offset of fru_information[1].description.uid incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[1].description.uid) == 6, "Size of fru_information[1].description.uid incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[1].description.manufacturer) == 290, "Offset of fru_information[1].description.manufacturer incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[1].description.manufacturer) == 60, "Size of fru_information[1].description.manufacturer incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[1].description.product) == 350, "Offset of fru_information[1].description.product incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[1].description.product) == 60, "Size of fru_information[1].description.product incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[1].description.part_nr) == 410, "Offset of fru_information[1].description.part_nr incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[1].description.part_nr) == 60, "Size of fru_information[1].description.part_nr incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[1].description.serial_nr) == 470, "Offset of fru_information[1].description.serial_nr incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[1].description.serial_nr) == 30, "Size of fru_information[1].description.serial_nr incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[1].description.version) == 500, "Offset of fru_information[1].description.version incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[1].description.version) == 20, "Size of fru_information[1].description.version incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[2].status.num_temp_sensors) == 521, "Offset of fru_information[2].status.num_temp_sensors incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[2].status.num_temp_sensors) == 1, "Size of fru_information[2].status.num_temp_sensors incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[2].status.temperature[0]) == 522, "Offset of fru_information[2].status.temperature[0] incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[2].status.temperature[0]) == 2, "Size of fru_information[2].status.temperature[0] incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[2].status.temperature[1]) == 524, "Offset of fru_information[2].status.temperature[1] incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[2].status.temperature[1]) == 2, "Size of fru_information[2].status.temperature[1] incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[2].status.temperature[2]) == 526, "Offset of fru_information[2].status.temperature[2] incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[2].status.temperature[2]) == 2, "Size of fru_information[2].status.temperature[2] incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[2].status.temperature[3]) == 528, "Offset of fru_information[2].status.temperature[3] incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[2].status.temperature[3]) == 2, "Size of fru_information[2].status.temperature[3] incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[2].status.temperature[4]) == 530, "Offset of fru_information[2].status.temperature[4] incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[2].status.temperature[4]) == 2, "Size of fru_information[2].status.temperature[4] incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[2].status.temperature[5]) == 532, "Offset of fru_information[2].status.temperature[5] incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[2].status.temperature[5]) == 2, "Size of fru_information[2].status.temperature[5] incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[2].status.temperature[6]) == 534, "Offset of fru_information[2].status.temperature[6] incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[2].status.temperature[6]) == 2, "Size of fru_information[2].status.temperature[6] incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[2].status.temperature[7]) == 536, "Offset of fru_information[2].status.temperature[7] incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[2].status.temperature[7]) == 2, "Size of fru_information[2].status.temperature[7] incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[2].status.ext) == 538, "Offset of fru_information[2].status.ext incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[2].status.ext) == 2, "Size of fru_information[2].status.ext incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[2].description.uid) == 540, "Offset of fru_information[2].description.uid incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[2].description.uid) == 6, "Size of fru_information[2].description.uid incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[2].description.manufacturer) == 546, "Offset of fru_information[2].description.manufacturer incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[2].description.manufacturer) == 60, "Size of fru_information[2].description.manufacturer incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[2].description.product) == 606, "Offset of fru_information[2].description.product incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[2].description.product) == 60, "Size of fru_information[2].description.product incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[2].description.part_nr) == 666, "Offset of fru_information[2].description.part_nr incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[2].description.part_nr) == 60, "Size of fru_information[2].description.part_nr incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[2].description.serial_nr) == 726, "Offset of fru_information[2].description.serial_nr incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[2].description.serial_nr) == 30, "Size of fru_information[2].description.serial_nr incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[2].description.version) == 756, "Offset of fru_information[2].description.version incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[2].description.version) == 20, "Size of fru_information[2].description.version incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[3].status.num_temp_sensors) == 777, "Offset of fru_information[3].status.num_temp_sensors incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[3].status.num_temp_sensors) == 1, "Size of fru_information[3].status.num_temp_sensors incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[3].status.temperature[0]) == 778, "Offset of fru_information[3].status.temperature[0] incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[3].status.temperature[0]) == 2, "Size of fru_information[3].status.temperature[0] incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[3].status.temperature[1]) == 780, "Offset of fru_information[3].status.temperature[1] incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[3].status.temperature[1]) == 2, "Size of fru_information[3].status.temperature[1] incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[3].status.temperature[2]) == 782, "Offset of fru_information[3].status.temperature[2] incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[3].status.temperature[2]) == 2, "Size of fru_information[3].status.temperature[2] incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[3].status.temperature[3]) == 784, "Offset of fru_information[3].status.temperature[3] incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[3].status.temperature[3]) == 2, "Size of fru_information[3].status.temperature[3] incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[3].status.temperature[4]) == 786, "Offset of fru_information[3].status.temperature[4] incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[3].status.temperature[4]) == 2, "Size of fru_information[3].status.temperature[4] incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[3].status.temperature[5]) == 788, "Offset of fru_information[3].status.temperature[5] incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[3].status.temperature[5]) == 2, "Size of fru_information[3].status.temperature[5] incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[3].status.temperature[6]) == 790, "Offset of fru_information[3].status.temperature[6] incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[3].status.temperature[6]) == 2, "Size of fru_information[3].status.temperature[6] incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[3].status.temperature[7]) == 792, "Offset of fru_information[3].status.temperature[7] incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[3].status.temperature[7]) == 2, "Size of fru_information[3].status.temperature[7] incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[3].status.ext) == 794, "Offset of fru_information[3].status.ext incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[3].status.ext) == 2, "Size of fru_information[3].status.ext incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[3].description.uid) == 796, "Offset of fru_information[3].description.uid incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[3].description.uid) == 6, "Size of fru_information[3].description.uid incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[3].description.manufacturer) == 802, "Offset of fru_information[3].description.manufacturer incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[3].description.manufacturer) == 60, "Size of fru_information[3].description.manufacturer incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[3].description.product) == 862, "Offset of fru_information[3].description.product incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[3].description.product) == 60, "Size of fru_information[3].description.product incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[3].description.part_nr) == 922, "Offset of fru_information[3].description.part_nr incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[3].description.part_nr) == 60, "Size of fru_information[3].description.part_nr incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[3].description.serial_nr) == 982, "Offset of fru_information[3].description.serial_nr incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[3].description.serial_nr) == 30, "Size of fru_information[3].description.serial_nr incorrect");
+static_assert(MB_EEPROM_OFFS(fru_information[3].description.version) == 1012, "Offset of fru_information[3].description.version incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fru_information[3].description.version) == 20, "Size of fru_information[3].description.version incorrect");
+static_assert(MB_EEPROM_OFFS(application_data) == 1032, "Offset of application_data incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->application_data) == 256, "Size of application_data incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_information.application_version.major) == 1288, "Offset of mmc_information.application_version.major incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_information.application_version.major) == 1, "Size of mmc_information.application_version.major incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_information.application_version.minor) == 1289, "Offset of mmc_information.application_version.minor incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_information.application_version.minor) == 1, "Size of mmc_information.application_version.minor incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_information.library_version.major) == 1290, "Offset of mmc_information.library_version.major incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_information.library_version.major) == 1, "Size of mmc_information.library_version.major incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_information.library_version.minor) == 1291, "Offset of mmc_information.library_version.minor incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_information.library_version.minor) == 1, "Size of mmc_information.library_version.minor incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_information.cpld_board_version.major) == 1292, "Offset of mmc_information.cpld_board_version.major incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_information.cpld_board_version.major) == 1, "Size of mmc_information.cpld_board_version.major incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_information.cpld_board_version.minor) == 1293, "Offset of mmc_information.cpld_board_version.minor incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_information.cpld_board_version.minor) == 1, "Size of mmc_information.cpld_board_version.minor incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_information.cpld_library_version.major) == 1294, "Offset of mmc_information.cpld_library_version.major incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_information.cpld_library_version.major) == 1, "Size of mmc_information.cpld_library_version.major incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_information.cpld_library_version.minor) == 1295, "Offset of mmc_information.cpld_library_version.minor incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_information.cpld_library_version.minor) == 1, "Size of mmc_information.cpld_library_version.minor incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_information.stamp_hw_revision) == 1296, "Offset of mmc_information.stamp_hw_revision incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_information.stamp_hw_revision) == 1, "Size of mmc_information.stamp_hw_revision incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_information.amc_slot_nr) == 1297, "Offset of mmc_information.amc_slot_nr incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_information.amc_slot_nr) == 1, "Size of mmc_information.amc_slot_nr incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_information.ipmb_addr) == 1298, "Offset of mmc_information.ipmb_addr incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_information.ipmb_addr) == 1, "Size of mmc_information.ipmb_addr incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_information.board_name) == 1299, "Offset of mmc_information.board_name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_information.board_name) == 23, "Size of mmc_information.board_name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_information.vendor_id) == 1322, "Offset of mmc_information.vendor_id incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_information.vendor_id) == 2, "Size of mmc_information.vendor_id incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_information.product_id) == 1324, "Offset of mmc_information.product_id incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_information.product_id) == 2, "Size of mmc_information.product_id incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_information.mmc_uptime) == 1326, "Offset of mmc_information.mmc_uptime incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_information.mmc_uptime) == 4, "Size of mmc_information.mmc_uptime incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_information.amc_hw_revision) == 1330, "Offset of mmc_information.amc_hw_revision incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_information.amc_hw_revision) == 1, "Size of mmc_information.amc_hw_revision incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_information.reserved) == 1331, "Offset of mmc_information.reserved incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_information.reserved) == 5, "Size of mmc_information.reserved incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[0].name) == 1336, "Offset of mmc_sensor[0].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[0].name) == 12, "Size of mmc_sensor[0].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[0].reading) == 1348, "Offset of mmc_sensor[0].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[0].reading) == 4, "Size of mmc_sensor[0].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[1].name) == 1352, "Offset of mmc_sensor[1].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[1].name) == 12, "Size of mmc_sensor[1].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[1].reading) == 1364, "Offset of mmc_sensor[1].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[1].reading) == 4, "Size of mmc_sensor[1].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[2].name) == 1368, "Offset of mmc_sensor[2].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[2].name) == 12, "Size of mmc_sensor[2].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[2].reading) == 1380, "Offset of mmc_sensor[2].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[2].reading) == 4, "Size of mmc_sensor[2].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[3].name) == 1384, "Offset of mmc_sensor[3].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[3].name) == 12, "Size of mmc_sensor[3].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[3].reading) == 1396, "Offset of mmc_sensor[3].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[3].reading) == 4, "Size of mmc_sensor[3].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[4].name) == 1400, "Offset of mmc_sensor[4].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[4].name) == 12, "Size of mmc_sensor[4].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[4].reading) == 1412, "Offset of mmc_sensor[4].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[4].reading) == 4, "Size of mmc_sensor[4].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[5].name) == 1416, "Offset of mmc_sensor[5].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[5].name) == 12, "Size of mmc_sensor[5].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[5].reading) == 1428, "Offset of mmc_sensor[5].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[5].reading) == 4, "Size of mmc_sensor[5].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[6].name) == 1432, "Offset of mmc_sensor[6].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[6].name) == 12, "Size of mmc_sensor[6].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[6].reading) == 1444, "Offset of mmc_sensor[6].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[6].reading) == 4, "Size of mmc_sensor[6].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[7].name) == 1448, "Offset of mmc_sensor[7].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[7].name) == 12, "Size of mmc_sensor[7].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[7].reading) == 1460, "Offset of mmc_sensor[7].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[7].reading) == 4, "Size of mmc_sensor[7].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[8].name) == 1464, "Offset of mmc_sensor[8].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[8].name) == 12, "Size of mmc_sensor[8].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[8].reading) == 1476, "Offset of mmc_sensor[8].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[8].reading) == 4, "Size of mmc_sensor[8].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[9].name) == 1480, "Offset of mmc_sensor[9].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[9].name) == 12, "Size of mmc_sensor[9].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[9].reading) == 1492, "Offset of mmc_sensor[9].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[9].reading) == 4, "Size of mmc_sensor[9].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[10].name) == 1496, "Offset of mmc_sensor[10].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[10].name) == 12, "Size of mmc_sensor[10].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[10].reading) == 1508, "Offset of mmc_sensor[10].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[10].reading) == 4, "Size of mmc_sensor[10].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[11].name) == 1512, "Offset of mmc_sensor[11].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[11].name) == 12, "Size of mmc_sensor[11].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[11].reading) == 1524, "Offset of mmc_sensor[11].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[11].reading) == 4, "Size of mmc_sensor[11].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[12].name) == 1528, "Offset of mmc_sensor[12].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[12].name) == 12, "Size of mmc_sensor[12].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[12].reading) == 1540, "Offset of mmc_sensor[12].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[12].reading) == 4, "Size of mmc_sensor[12].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[13].name) == 1544, "Offset of mmc_sensor[13].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[13].name) == 12, "Size of mmc_sensor[13].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[13].reading) == 1556, "Offset of mmc_sensor[13].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[13].reading) == 4, "Size of mmc_sensor[13].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[14].name) == 1560, "Offset of mmc_sensor[14].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[14].name) == 12, "Size of mmc_sensor[14].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[14].reading) == 1572, "Offset of mmc_sensor[14].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[14].reading) == 4, "Size of mmc_sensor[14].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[15].name) == 1576, "Offset of mmc_sensor[15].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[15].name) == 12, "Size of mmc_sensor[15].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[15].reading) == 1588, "Offset of mmc_sensor[15].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[15].reading) == 4, "Size of mmc_sensor[15].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[16].name) == 1592, "Offset of mmc_sensor[16].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[16].name) == 12, "Size of mmc_sensor[16].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[16].reading) == 1604, "Offset of mmc_sensor[16].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[16].reading) == 4, "Size of mmc_sensor[16].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[17].name) == 1608, "Offset of mmc_sensor[17].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[17].name) == 12, "Size of mmc_sensor[17].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[17].reading) == 1620, "Offset of mmc_sensor[17].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[17].reading) == 4, "Size of mmc_sensor[17].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[18].name) == 1624, "Offset of mmc_sensor[18].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[18].name) == 12, "Size of mmc_sensor[18].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[18].reading) == 1636, "Offset of mmc_sensor[18].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[18].reading) == 4, "Size of mmc_sensor[18].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[19].name) == 1640, "Offset of mmc_sensor[19].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[19].name) == 12, "Size of mmc_sensor[19].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[19].reading) == 1652, "Offset of mmc_sensor[19].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[19].reading) == 4, "Size of mmc_sensor[19].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[20].name) == 1656, "Offset of mmc_sensor[20].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[20].name) == 12, "Size of mmc_sensor[20].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[20].reading) == 1668, "Offset of mmc_sensor[20].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[20].reading) == 4, "Size of mmc_sensor[20].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[21].name) == 1672, "Offset of mmc_sensor[21].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[21].name) == 12, "Size of mmc_sensor[21].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[21].reading) == 1684, "Offset of mmc_sensor[21].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[21].reading) == 4, "Size of mmc_sensor[21].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[22].name) == 1688, "Offset of mmc_sensor[22].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[22].name) == 12, "Size of mmc_sensor[22].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[22].reading) == 1700, "Offset of mmc_sensor[22].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[22].reading) == 4, "Size of mmc_sensor[22].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[23].name) == 1704, "Offset of mmc_sensor[23].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[23].name) == 12, "Size of mmc_sensor[23].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[23].reading) == 1716, "Offset of mmc_sensor[23].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[23].reading) == 4, "Size of mmc_sensor[23].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[24].name) == 1720, "Offset of mmc_sensor[24].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[24].name) == 12, "Size of mmc_sensor[24].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[24].reading) == 1732, "Offset of mmc_sensor[24].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[24].reading) == 4, "Size of mmc_sensor[24].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[25].name) == 1736, "Offset of mmc_sensor[25].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[25].name) == 12, "Size of mmc_sensor[25].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[25].reading) == 1748, "Offset of mmc_sensor[25].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[25].reading) == 4, "Size of mmc_sensor[25].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[26].name) == 1752, "Offset of mmc_sensor[26].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[26].name) == 12, "Size of mmc_sensor[26].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[26].reading) == 1764, "Offset of mmc_sensor[26].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[26].reading) == 4, "Size of mmc_sensor[26].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[27].name) == 1768, "Offset of mmc_sensor[27].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[27].name) == 12, "Size of mmc_sensor[27].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[27].reading) == 1780, "Offset of mmc_sensor[27].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[27].reading) == 4, "Size of mmc_sensor[27].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[28].name) == 1784, "Offset of mmc_sensor[28].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[28].name) == 12, "Size of mmc_sensor[28].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[28].reading) == 1796, "Offset of mmc_sensor[28].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[28].reading) == 4, "Size of mmc_sensor[28].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[29].name) == 1800, "Offset of mmc_sensor[29].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[29].name) == 12, "Size of mmc_sensor[29].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[29].reading) == 1812, "Offset of mmc_sensor[29].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[29].reading) == 4, "Size of mmc_sensor[29].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[30].name) == 1816, "Offset of mmc_sensor[30].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[30].name) == 12, "Size of mmc_sensor[30].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[30].reading) == 1828, "Offset of mmc_sensor[30].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[30].reading) == 4, "Size of mmc_sensor[30].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[31].name) == 1832, "Offset of mmc_sensor[31].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[31].name) == 12, "Size of mmc_sensor[31].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[31].reading) == 1844, "Offset of mmc_sensor[31].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[31].reading) == 4, "Size of mmc_sensor[31].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[32].name) == 1848, "Offset of mmc_sensor[32].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[32].name) == 12, "Size of mmc_sensor[32].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[32].reading) == 1860, "Offset of mmc_sensor[32].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[32].reading) == 4, "Size of mmc_sensor[32].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[33].name) == 1864, "Offset of mmc_sensor[33].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[33].name) == 12, "Size of mmc_sensor[33].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[33].reading) == 1876, "Offset of mmc_sensor[33].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[33].reading) == 4, "Size of mmc_sensor[33].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[34].name) == 1880, "Offset of mmc_sensor[34].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[34].name) == 12, "Size of mmc_sensor[34].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[34].reading) == 1892, "Offset of mmc_sensor[34].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[34].reading) == 4, "Size of mmc_sensor[34].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[35].name) == 1896, "Offset of mmc_sensor[35].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[35].name) == 12, "Size of mmc_sensor[35].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[35].reading) == 1908, "Offset of mmc_sensor[35].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[35].reading) == 4, "Size of mmc_sensor[35].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[36].name) == 1912, "Offset of mmc_sensor[36].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[36].name) == 12, "Size of mmc_sensor[36].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[36].reading) == 1924, "Offset of mmc_sensor[36].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[36].reading) == 4, "Size of mmc_sensor[36].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[37].name) == 1928, "Offset of mmc_sensor[37].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[37].name) == 12, "Size of mmc_sensor[37].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[37].reading) == 1940, "Offset of mmc_sensor[37].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[37].reading) == 4, "Size of mmc_sensor[37].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[38].name) == 1944, "Offset of mmc_sensor[38].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[38].name) == 12, "Size of mmc_sensor[38].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[38].reading) == 1956, "Offset of mmc_sensor[38].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[38].reading) == 4, "Size of mmc_sensor[38].reading incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[39].name) == 1960, "Offset of mmc_sensor[39].name incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[39].name) == 12, "Size of mmc_sensor[39].name incorrect");
+static_assert(MB_EEPROM_OFFS(mmc_sensor[39].reading) == 1972, "Offset of mmc_sensor[39].reading incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->mmc_sensor[39].reading) == 4, "Size of mmc_sensor[39].reading incorrect");
+static_assert(MB_EEPROM_OFFS(reserved) == 1976, "Offset of reserved incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->reserved) == 43, "Size of reserved incorrect");
+static_assert(MB_EEPROM_OFFS(bp_eth_info.mac_addr) == 2019, "Offset of bp_eth_info.mac_addr incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->bp_eth_info.mac_addr) == 6, "Size of bp_eth_info.mac_addr incorrect");
+static_assert(MB_EEPROM_OFFS(bp_eth_info.ipv4_addr) == 2025, "Offset of bp_eth_info.ipv4_addr incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->bp_eth_info.ipv4_addr) == 4, "Size of bp_eth_info.ipv4_addr incorrect");
+static_assert(MB_EEPROM_OFFS(bp_eth_info.ipv6_addr) == 2029, "Offset of bp_eth_info.ipv6_addr incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->bp_eth_info.ipv6_addr) == 16, "Size of bp_eth_info.ipv6_addr incorrect");
+static_assert(MB_EEPROM_OFFS(fpga_ctrl) == 2045, "Offset of fpga_ctrl incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fpga_ctrl) == 1, "Size of fpga_ctrl incorrect");
+static_assert(MB_EEPROM_OFFS(fpga_status) == 2046, "Offset of fpga_status incorrect");
+static_assert(sizeof(MB_MEM_DUMMY->fpga_status) == 1, "Size of fpga_status incorrect");
@@ -26,6 +26,10 @@ extern "C" {
 // Check MMC Mailbox magic string
 bool mb_check_magic(void);
 
+// Get mailbox layout version (selected from the version byte when opening the mailbox),
+// 0 on error
+unsigned mb_get_version(void);
+
 // Get MMC information
 bool mb_get_mmc_information(mb_mmc_information_t* info);
 
@@ -38,7 +42,11 @@ bool mb_get_fru_description(mb_fru_description_t* desc, size_t fru_id);
 // Get FRU status of <fru_id> (0=AMC, 1=RTM, 2=FMC1, 3=FMC2)
 bool mb_get_fru_status(mb_fru_status_t* stat, size_t fru_id);
 
-// Get application specific data, <len> bytes at <offs> offset into the data block
+// Get a consistent snapshot of the whole mailbox contents (single transaction)
+bool mb_get_snapshot(mb_memory_contents_t* snap);
+
+// Get application specific data, <len> bytes at <offs> offset into the data block.
+// See mmcmb_appdata.h for parsing it.
 bool mb_get_application_specific_data(void* buf, size_t offs, size_t len);
 
 // Get FPGA control
@@ -53,6 +61,38 @@ bool mb_set_bp_eth_info(const mb_nic_information_t* nic_info);
 // Get mmc-mailbox "EEPROM" device path, returns NULL on error
 const char* mb_get_eeprom_path(void);
 
+// Use <path> as the mailbox "EEPROM" device instead of looking up the device tree compatible
+// I2C device in sysfs, e.g. to save the scan at startup. Must be called before the mailbox
+// is opened, returns false otherwise.
+bool mb_set_eeprom_path(const char* path);
+
+/* Snapshot cache (opt-in)
+ *
+ * The MMC updates the mailbox once per second, so repeated reads within that period
+ * return the same data. With the cache enabled, the first read within <ttl_ms> fetches
+ * the whole mailbox in a single transaction and the getters above are served from that
+ * snapshot. Writes go to the mailbox and the cache; the FPGA control flags are always
+ * read from the mailbox.
+ */
+
+#define MB_CACHE_DEFAULT_TTL_MS 1000
+
+// Enable the cache, with a time-to-live of <ttl_ms> (0: MB_CACHE_DEFAULT_TTL_MS)
+void mb_cache_enable(unsigned ttl_ms);
+
+// Disable the cache, all reads go to the mailbox again
+void mb_cache_disable(void);
+
+// Drop the cached snapshot, the next read fetches a new one
+void mb_cache_invalidate(void);
+
+// Invalidate <len> bytes at mailbox offset <offs> (e.g. MB_EEPROM_OFFS(mmc_sensor)),
+// they are re-read on next access without refreshing the rest of the snapshot
+void mb_cache_invalidate_range(size_t offs, size_t len);
+
+// Fetch a new snapshot now, returns false on error or if the cache is disabled
+bool mb_cache_refresh(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,118 @@
+/***************************************************************************
+ *      ____  _____________  __    __  __ _           _____ ___   _        *
+ *     / __ \/ ____/ ___/\ \/ /   |  \/  (_)__ _ _ __|_   _/ __| /_\  (R)  *
+ *    / / / / __/  \__ \  \  /    | |\/| | / _| '_/ _ \| || (__ / _ \      *
+ *   / /_/ / /___ ___/ /  / /     |_|  |_|_\__|_| \___/|_| \___/_/ \_\     *
+ *  /_____/_____//____/  /_/      T  E  C  H  N  O  L  O  G  Y   L A B     *
+ *                                                                         *
+ *          Copyright 2022 Deutsches Elektronen-Synchrotron DESY.          *
+ *                          All rights reserved.                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fpga_mailbox_layout.h"
+
+/* Application-specific data schema
+ *
+ * The 256-byte application data block has no fixed layout. Boards which want to use it
+ * in a self-describing way put a TLV list there:
+ *
+ *   Offset  Size  Content
+ *   0       2     Magic "AD"
+ *   2       1     Schema version (MB_APPDATA_VERSION)
+ *   3       1     Reserved (0)
+ *   4       ...   Records: type (1 byte), length (1 byte), value (<length> bytes)
+ *
+ * The record list ends with a record of type MB_APPDATA_END (or 0xff, i.e. erased
+ * memory), or at the end of the block. Types 1..0xfe are board-specific; multi-byte
+ * values are little-endian.
+ *
+ * The parser works in place on the data block (e.g. snapshot->application_data),
+ * records point into it.
+ */
+
+#define MB_APPDATA_SIZE MB_NUM_ELEMS(application_data)
+#define MB_APPDATA_MAGIC "AD"
+#define MB_APPDATA_VERSION 1
+#define MB_APPDATA_HDR_SIZE 4
+
+#define MB_APPDATA_END 0x00
+#define MB_APPDATA_ERASED 0xff
+
+typedef struct mb_appdata_rec {
+    uint8_t type;
+    uint8_t len;
+    const uint8_t* value;  // Points into the data block
+} mb_appdata_rec_t;
+
+typedef struct mb_appdata_iter {
+    const uint8_t* data;
+    size_t pos;
+    bool error;  // Malformed record (overruns the block) at <pos>
+} mb_appdata_iter_t;
+
+// Check the header of data block <data>, returns false if it has no (supported) schema
+bool mb_appdata_has_schema(const uint8_t* data);
+
+// Start iterating over the records of data block <data>, returns false if it has no schema
+bool mb_appdata_iter_init(mb_appdata_iter_t* it, const uint8_t* data);
+
+// Get the next record, returns false at the end of the list or on a malformed record
+bool mb_appdata_next(mb_appdata_iter_t* it, mb_appdata_rec_t* rec);
+
+// Find the first record of <type>, returns false if there is none
+bool mb_appdata_find(const uint8_t* data, uint8_t type, mb_appdata_rec_t* rec);
+
+// Typed record values, return false if the record length doesn't match the type
+bool mb_appdata_get_u8(const mb_appdata_rec_t* rec, uint8_t* val);
+bool mb_appdata_get_u16(const mb_appdata_rec_t* rec, uint16_t* val);
+bool mb_appdata_get_u32(const mb_appdata_rec_t* rec, uint32_t* val);
+bool mb_appdata_get_float(const mb_appdata_rec_t* rec, float* val);
+
+// Copy a string record into <buf> (zero-terminated), returns false if it doesn't fit
+bool mb_appdata_get_str(const mb_appdata_rec_t* rec, char* buf, size_t len);
+
+/* Writing a data block, e.g. for board firmware or test images */
+
+typedef struct mb_appdata_writer {
+    uint8_t* data;
+    size_t pos;
+} mb_appdata_writer_t;
+
+// Start a new record list in data block <data> (MB_APPDATA_SIZE bytes)
+void mb_appdata_writer_init(mb_appdata_writer_t* w, uint8_t* data);
+
+// Append a record, returns false if it doesn't fit
+bool mb_appdata_add(mb_appdata_writer_t* w, uint8_t type, const void* value, uint8_t len);
+
+/* Change notification
+ *
+ * Consumers polling the data block feed it to mb_appdata_changed() and only reparse it
+ * if any byte of it changed. The check is a plain compare against a copy of the block,
+ * the records are not parsed.
+ */
+
+typedef struct mb_appdata_watch {
+    bool valid;
+    uint8_t data[MB_APPDATA_SIZE];  // Block at the last call
+} mb_appdata_watch_t;
+
+// Initialize a watch, the first mb_appdata_changed() call always reports a change
+void mb_appdata_watch_init(mb_appdata_watch_t* w);
+
+// Returns true if the content of data block <data> changed since the last call
+bool mb_appdata_changed(mb_appdata_watch_t* w, const uint8_t* data);
+
+#ifdef __cplusplus
+}
+#endif
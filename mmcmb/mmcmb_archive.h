@@ -0,0 +1,138 @@
+/***************************************************************************
+ *      ____  _____________  __    __  __ _           _____ ___   _        *
+ *     / __ \/ ____/ ___/\ \/ /   |  \/  (_)__ _ _ __|_   _/ __| /_\  (R)  *
+ *    / / / / __/  \__ \  \  /    | |\/| | / _| '_/ _ \| || (__ / _ \      *
+ *   / /_/ / /___ ___/ /  / /     |_|  |_|_\__|_| \___/|_| \___/_/ \_\     *
+ *  /_____/_____//____/  /_/      T  E  C  H  N  O  L  O  G  Y   L A B     *
+ *                                                                         *
+ *          Copyright 2022 Deutsches Elektronen-Synchrotron DESY.          *
+ *                          All rights reserved.                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fpga_mailbox_layout.h"
+
+/* Mailbox history archive
+ *
+ * File layout (all fields little-endian):
+ *
+ *   mb_archive_header_t
+ *   frame 0: mb_archive_frame_t + payload
+ *   frame 1: mb_archive_frame_t + payload
+ *   ...
+ *   index:   uint64_t count, mb_archive_index_entry_t[count]
+ *
+ * A keyframe carries the full mailbox contents, a delta frame carries the byte runs
+ * that changed since the previous frame. Every keyframe is listed in the index, so a
+ * reader can seek to the last keyframe before a point in time and only has to touch
+ * the pages between there and the end of the requested time range.
+ *
+ * The index is written when the archive is finished. Archives that were not finished
+ * (e.g. recorder killed) are still readable, the index is then rebuilt by a scan. The
+ * same applies if the index doesn't match the frames.
+ */
+
+#define MB_ARCHIVE_MAGIC "MMCMBARC"
+#define MB_ARCHIVE_FORMAT_VERSION 1
+#define MB_ARCHIVE_FRAME_MAGIC 0x4652424d /* "MBRF" */
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wattributes"
+#pragma GCC diagnostic ignored "-Wpacked"
+
+typedef struct mb_archive_header {
+    char magic[8];
+    uint16_t format_version;
+    uint16_t snapshot_size;
+    uint32_t keyframe_interval;
+    uint64_t index_offs; /* 0 if the archive was not finished */
+    uint64_t reserved;
+} MB_PACKED mb_archive_header_t;
+
+enum { MB_ARCHIVE_KEYFRAME = 'K', MB_ARCHIVE_DELTA = 'D' };
+
+typedef struct mb_archive_frame {
+    uint32_t magic;
+    uint8_t type;
+    uint8_t reserved[3];
+    uint32_t payload_len;
+    uint64_t timestamp_ns;
+} MB_PACKED mb_archive_frame_t;
+
+/* Delta payload is a sequence of runs, each followed by <len> bytes of data */
+typedef struct mb_archive_run {
+    uint16_t offs;
+    uint16_t len;
+} MB_PACKED mb_archive_run_t;
+
+typedef struct mb_archive_index_entry {
+    uint64_t timestamp_ns;
+    uint64_t frame_offs;
+} MB_PACKED mb_archive_index_entry_t;
+
+#pragma GCC diagnostic pop
+
+/* Delta helpers */
+
+// Encode the differences between <prev> and <cur> (<n> bytes each) into <out>.
+// Returns the encoded length, or 0 if the delta would not fit into <out_len> bytes.
+// Identical buffers encode to an empty delta, check with memcmp() beforehand if needed.
+size_t mb_delta_encode(const void* prev, const void* cur, size_t n, void* out, size_t out_len);
+
+// Apply an encoded delta to <buf> (<n> bytes), returns false if the delta is malformed
+bool mb_delta_apply(void* buf, size_t n, const void* delta, size_t len);
+
+/* Writer */
+
+typedef struct mb_archive_writer mb_archive_writer_t;
+
+// Create a new archive, writing a keyframe every <keyframe_interval> frames. Returns NULL on error.
+mb_archive_writer_t* mb_archive_create(const char* path, unsigned keyframe_interval);
+
+// Append a snapshot taken at <timestamp_ns> (must be monotonic within the archive)
+bool mb_archive_append(mb_archive_writer_t* w,
+                       uint64_t timestamp_ns,
+                       const mb_memory_contents_t* snap);
+
+// Write the index, close the file and free the writer. Returns true for success.
+bool mb_archive_finish(mb_archive_writer_t* w);
+
+/* Reader (mmap based) */
+
+typedef struct mb_archive mb_archive_t;
+
+// Open an archive for reading, returns NULL on error
+mb_archive_t* mb_archive_open(const char* path);
+
+// Unmap and free the archive
+void mb_archive_close(mb_archive_t* ar);
+
+// Number of keyframes and time range covered by the archive
+size_t mb_archive_num_keyframes(const mb_archive_t* ar);
+uint64_t mb_archive_first_timestamp(const mb_archive_t* ar);
+uint64_t mb_archive_last_timestamp(const mb_archive_t* ar);
+
+// Callback for mb_archive_query(), return false to stop the iteration
+typedef bool (*mb_archive_cb_t)(uint64_t timestamp_ns, const mb_memory_contents_t* snap, void* arg);
+
+// Call <cb> for each snapshot with t0_ns <= timestamp <= t1_ns, in ascending order.
+// Returns false if the archive is corrupt.
+bool mb_archive_query(const mb_archive_t* ar,
+                      uint64_t t0_ns,
+                      uint64_t t1_ns,
+                      mb_archive_cb_t cb,
+                      void* arg);
+
+#ifdef __cplusplus
+}
+#endif
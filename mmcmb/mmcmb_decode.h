@@ -0,0 +1,88 @@
+/***************************************************************************
+ *      ____  _____________  __    __  __ _           _____ ___   _        *
+ *     / __ \/ ____/ ___/\ \/ /   |  \/  (_)__ _ _ __|_   _/ __| /_\  (R)  *
+ *    / / / / __/  \__ \  \  /    | |\/| | / _| '_/ _ \| || (__ / _ \      *
+ *   / /_/ / /___ ___/ /  / /     |_|  |_|_\__|_| \___/|_| \___/_/ \_\     *
+ *  /_____/_____//____/  /_/      T  E  C  H  N  O  L  O  G  Y   L A B     *
+ *                                                                         *
+ *          Copyright 2022 Deutsches Elektronen-Synchrotron DESY.          *
+ *                          All rights reserved.                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fpga_mailbox_layout.h"
+
+/* Decoded mailbox data types
+ *
+ * Naturally aligned, native-endian mirrors of the packed layout types. Field access on
+ * the packed types compiles to byte-wise loads (plus byte swaps on big-endian hosts),
+ * so consumers evaluating the data many times per cycle should decode a snapshot once
+ * and work on these instead.
+ */
+
+typedef struct mb_fru_status_decoded {
+    bool present;
+    bool compatible;
+    bool powered;
+    bool failure;
+    // FMC-specific flags, only meaningful for FRU 2 & 3
+    bool hspc_prsnt;
+    bool clk_dir;
+    bool pg_m2c;
+    uint8_t num_temp_sensors;             // Clamped to MAX_SENS_PER_FRU
+    float temperature[MAX_SENS_PER_FRU];  // Deg. C, NaN if N/A or unused
+} mb_fru_status_decoded_t;
+
+typedef struct mb_version_decoded {
+    uint8_t major;
+    uint8_t minor;
+} mb_version_decoded_t;
+
+typedef struct mb_mmc_information_decoded {
+    mb_version_decoded_t application_version;
+    mb_version_decoded_t library_version;
+    mb_version_decoded_t cpld_board_version;
+    mb_version_decoded_t cpld_library_version;
+    char stamp_hw_revision;
+    uint8_t amc_slot_nr;
+    uint8_t ipmb_addr;
+    char board_name[sizeof(MB_MEM_DUMMY->mmc_information.board_name) + 1];  // Zero-terminated
+    uint16_t vendor_id;
+    uint16_t product_id;
+    uint32_t mmc_uptime;
+    char amc_hw_revision;  // '\0' if N/A
+} mb_mmc_information_decoded_t;
+
+typedef struct mb_mmc_sensor_decoded {
+    char name[sizeof(MB_MEM_DUMMY->mmc_sensor[0].name) + 1];  // Zero-terminated
+    float reading;                                            // NaN if N/A or read error
+} mb_mmc_sensor_decoded_t;
+
+typedef struct mb_decoded {
+    uint8_t mailbox_version;
+    mb_fru_status_decoded_t fru_status[NUM_FRUS];
+    mb_mmc_information_decoded_t mmc_information;
+    size_t num_mmc_sensors;  // Number of used sensor slots (up to the first unnamed one)
+    mb_mmc_sensor_decoded_t mmc_sensor[MAX_SENS_MMC];
+} mb_decoded_t;
+
+// Decode a raw mailbox snapshot in a single pass, using the decoder for its mailbox version.
+// Returns false if the version is not supported.
+bool mb_decode_snapshot(const mb_memory_contents_t* raw, mb_decoded_t* dec);
+
+// Read a snapshot from the mailbox and decode it, returns true for success
+bool mb_get_decoded(mb_decoded_t* dec);
+
+#ifdef __cplusplus
+}
+#endif
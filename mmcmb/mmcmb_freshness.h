@@ -0,0 +1,99 @@
+/***************************************************************************
+ *      ____  _____________  __    __  __ _           _____ ___   _        *
+ *     / __ \/ ____/ ___/\ \/ /   |  \/  (_)__ _ _ __|_   _/ __| /_\  (R)  *
+ *    / / / / __/  \__ \  \  /    | |\/| | / _| '_/ _ \| || (__ / _ \      *
+ *   / /_/ / /___ ___/ /  / /     |_|  |_|_\__|_| \___/|_| \___/_/ \_\     *
+ *  /_____/_____//____/  /_/      T  E  C  H  N  O  L  O  G  Y   L A B     *
+ *                                                                         *
+ *          Copyright 2022 Deutsches Elektronen-Synchrotron DESY.          *
+ *                          All rights reserved.                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fpga_mailbox_layout.h"
+
+/* Data freshness & MMC liveness monitor
+ *
+ * The MMC updates the mailbox once per second, and mmc_information.mmc_uptime advances
+ * with every update. The monitor tracks its progression to tell how old the data is.
+ *
+ * Data goes stale if the MMC is stuck, or if readers hold the page lock so often that
+ * the MMC can't swap pages. Both can be told apart after recovery: if the uptime has
+ * caught up with the wall clock, the MMC was running but its updates were held back.
+ */
+
+#define MB_FRESHNESS_DEFAULT_STALE_MS 3000
+
+typedef enum mb_freshness_state {
+    MB_FRESHNESS_UNKNOWN,    // No data yet
+    MB_FRESHNESS_FRESH,      // Uptime progressing
+    MB_FRESHNESS_STALE,      // Uptime not progressing for more than stale_ms
+    MB_FRESHNESS_RESTARTED,  // Uptime went backwards (MMC reboot), monitor restarted
+} mb_freshness_state_t;
+
+typedef struct mb_freshness {
+    unsigned stale_ms;
+    mb_freshness_state_t state;
+
+    // Last observed uptime change
+    uint32_t uptime;
+    uint64_t change_ns;
+
+    // Last observed sensor reading change
+    uint64_t sensor_hash;
+    uint64_t sensor_change_ns;
+
+    // Update rate measurement window
+    uint64_t window_start_ns;
+    unsigned window_changes;
+    double update_rate_hz;
+
+    // Event counters
+    unsigned stale_events;  // Transitions into MB_FRESHNESS_STALE
+    unsigned held_back;     // Stale periods with the MMC running (e.g. page lock held)
+    unsigned mmc_stalls;    // Stale periods with the MMC uptime not advancing
+    unsigned mmc_restarts;
+} mb_freshness_t;
+
+// Initialize the monitor, data is considered stale after <stale_ms> without an update
+void mb_freshness_init(mb_freshness_t* f, unsigned stale_ms);
+
+// Current CLOCK_MONOTONIC time in ns, for use as <now_ns>
+uint64_t mb_freshness_now_ns(void);
+
+// Feed an mmc_uptime reading taken at <now_ns>, returns the new state
+mb_freshness_state_t mb_freshness_update(mb_freshness_t* f, uint32_t mmc_uptime, uint64_t now_ns);
+
+// Feed MMC sensor readings taken at <now_ns> (optional, for mb_freshness_sensor_age_ms())
+void mb_freshness_update_sensors(mb_freshness_t* f,
+                                 const mb_mmc_sensor_t* sen,
+                                 size_t n,
+                                 uint64_t now_ns);
+
+// Feed a whole snapshot (uptime & sensors), returns the new state
+mb_freshness_state_t mb_freshness_update_snapshot(mb_freshness_t* f,
+                                                  const mb_memory_contents_t* snap,
+                                                  uint64_t now_ns);
+
+// Time since the last observed MMC update (the data itself is up to 1 s older)
+uint64_t mb_freshness_age_ms(const mb_freshness_t* f, uint64_t now_ns);
+
+// Time since the sensor readings last changed
+uint64_t mb_freshness_sensor_age_ms(const mb_freshness_t* f, uint64_t now_ns);
+
+// Human-readable state name
+const char* mb_freshness_state_str(mb_freshness_state_t state);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,71 @@
+/***************************************************************************
+ *      ____  _____________  __    __  __ _           _____ ___   _        *
+ *     / __ \/ ____/ ___/\ \/ /   |  \/  (_)__ _ _ __|_   _/ __| /_\  (R)  *
+ *    / / / / __/  \__ \  \  /    | |\/| | / _| '_/ _ \| || (__ / _ \      *
+ *   / /_/ / /___ ___/ /  / /     |_|  |_|_\__|_| \___/|_| \___/_/ \_\     *
+ *  /_____/_____//____/  /_/      T  E  C  H  N  O  L  O  G  Y   L A B     *
+ *                                                                         *
+ *          Copyright 2022 Deutsches Elektronen-Synchrotron DESY.          *
+ *                          All rights reserved.                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fpga_mailbox_layout.h"
+
+/* Name-indexed MMC sensor lookup
+ *
+ * MMC sensor slots are identified by their (up to 12 chars) name. The index maps names
+ * to slots via an open-addressing hash table built from the sensor name table, so a
+ * lookup is O(1) instead of a linear scan over all slots.
+ */
+
+#define MB_SENSOR_NAME_LEN sizeof(MB_MEM_DUMMY->mmc_sensor[0].name)
+#define MB_SENSOR_INDEX_BUCKETS 64  // Power of two, > MAX_SENS_MMC
+
+typedef struct mb_sensor_index {
+    char names[MAX_SENS_MMC][MB_SENSOR_NAME_LEN];  // Name table the index was built from
+    int8_t bucket[MB_SENSOR_INDEX_BUCKETS];        // Sensor slot, -1 if empty
+} mb_sensor_index_t;
+
+// Build the index from the MAX_SENS_MMC entries of <sen> (e.g. snapshot->mmc_sensor).
+// Unnamed slots are skipped; if a name occurs more than once, the first slot wins.
+void mb_sensor_index_build(mb_sensor_index_t* idx, const mb_mmc_sensor_t* sen);
+
+// Rebuild the index if the name table of <sen> differs from the indexed one.
+// Returns true if the index was rebuilt.
+bool mb_sensor_index_update(mb_sensor_index_t* idx, const mb_mmc_sensor_t* sen);
+
+// Get the slot of sensor <name>, -1 if there is no such sensor
+int mb_sensor_index_find(const mb_sensor_index_t* idx, const char* name);
+
+/* Live mailbox access, using an index of the library's own
+ *
+ * The index is built on first use. It is rebuilt if a fetched slot turns out to carry
+ * another name (e.g. after an MMC firmware update), and on lookup misses, at most once
+ * per MMC update period.
+ */
+
+// Get the slot of sensor <name>, -1 if there is no such sensor or on error
+int mb_find_sensor(const char* name);
+
+// Get the sensors named <names>[0..n-1] into <sen>[0..n-1]. Only the slots of the
+// requested sensors are read, neighbouring slots in a single transaction.
+// Sensors which don't exist are returned with an empty name and a NaN reading.
+bool mb_get_mmc_sensors_by_name(mb_mmc_sensor_t* sen, const char* const* names, size_t n);
+
+// Drop the library's index, it is rebuilt on next use
+void mb_sensor_index_invalidate(void);
+
+#ifdef __cplusplus
+}
+#endif
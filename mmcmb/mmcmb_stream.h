@@ -0,0 +1,105 @@
+/***************************************************************************
+ *      ____  _____________  __    __  __ _           _____ ___   _        *
+ *     / __ \/ ____/ ___/\ \/ /   |  \/  (_)__ _ _ __|_   _/ __| /_\  (R)  *
+ *    / / / / __/  \__ \  \  /    | |\/| | / _| '_/ _ \| || (__ / _ \      *
+ *   / /_/ / /___ ___/ /  / /     |_|  |_|_\__|_| \___/|_| \___/_/ \_\     *
+ *  /_____/_____//____/  /_/      T  E  C  H  N  O  L  O  G  Y   L A B     *
+ *                                                                         *
+ *          Copyright 2022 Deutsches Elektronen-Synchrotron DESY.          *
+ *                          All rights reserved.                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fpga_mailbox_layout.h"
+
+/* Snapshot stream protocol
+ *
+ * Used by mmcctrld to publish its mailbox snapshots on a Unix socket, and by mmccrated
+ * to serve the merged crate view. Every message is an mb_stream_hdr_t followed by
+ * <payload_len> bytes (all fields little-endian):
+ *
+ *   MB_STREAM_KEYFRAME  full mailbox contents of the board
+ *   MB_STREAM_DELTA     changes since the board's previous message (mb_delta_encode())
+ *   MB_STREAM_REMOVE    board gone, no payload
+ *   MB_STREAM_SYNC      end of the initial view, no payload
+ *
+ * Boards are identified by their AMC slot number & IPMB address. A subscriber first
+ * gets a keyframe for every board (followed by MB_STREAM_SYNC from mmccrated), then
+ * only deltas.
+ */
+
+#define MB_STREAM_MAGIC 0x5453424d /* "MBST" */
+#define MB_STREAM_MAX_PAYLOAD sizeof(mb_memory_contents_t)
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wattributes"
+#pragma GCC diagnostic ignored "-Wpacked"
+
+enum {
+    MB_STREAM_KEYFRAME = 'K',
+    MB_STREAM_DELTA = 'D',
+    MB_STREAM_REMOVE = 'R',
+    MB_STREAM_SYNC = 'S',
+};
+
+typedef struct mb_stream_hdr {
+    uint32_t magic;
+    uint8_t type;
+    uint8_t amc_slot_nr;
+    uint8_t ipmb_addr;
+    uint8_t reserved;
+    uint32_t payload_len;
+    uint64_t timestamp_ns;  // CLOCK_REALTIME time of the snapshot
+} MB_PACKED mb_stream_hdr_t;
+
+#pragma GCC diagnostic pop
+
+// Send a message, without blocking. Returns false if it could not be sent completely,
+// the stream is out of sync then and the connection has to be closed.
+bool mb_stream_send(int fd, const mb_stream_hdr_t* hdr, const void* payload);
+
+// Send snapshot <cur> of the board it describes: a delta against <prev>, or a keyframe
+// if <prev> is NULL. Nothing is sent if the snapshots are identical.
+bool mb_stream_send_snapshot(int fd,
+                             uint64_t timestamp_ns,
+                             const mb_memory_contents_t* prev,
+                             const mb_memory_contents_t* cur);
+
+// Receive buffer for one message
+typedef struct mb_stream_rx {
+    size_t fill;
+    union {
+        mb_stream_hdr_t hdr;
+        uint8_t buf[sizeof(mb_stream_hdr_t) + MB_STREAM_MAX_PAYLOAD];
+    };
+} mb_stream_rx_t;
+
+void mb_stream_rx_init(mb_stream_rx_t* rx);
+
+// Read from <fd> (may be non-blocking) until a message is complete.
+// Returns 1 if rx holds a complete message (call mb_stream_rx_init() once it is
+// processed), 0 if more data is needed, -1 on EOF, errors or protocol errors.
+int mb_stream_recv(mb_stream_rx_t* rx, int fd);
+
+// Payload of a received message
+static inline const uint8_t* mb_stream_payload(const mb_stream_rx_t* rx)
+{
+    return &rx->buf[sizeof(mb_stream_hdr_t)];
+}
+
+// Apply a received keyframe or delta to <snap>, returns false if the message is malformed
+bool mb_stream_apply(const mb_stream_rx_t* rx, mb_memory_contents_t* snap);
+
+#ifdef __cplusplus
+}
+#endif
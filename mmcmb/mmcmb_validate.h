@@ -0,0 +1,88 @@
+/***************************************************************************
+ *      ____  _____________  __    __  __ _           _____ ___   _        *
+ *     / __ \/ ____/ ___/\ \/ /   |  \/  (_)__ _ _ __|_   _/ __| /_\  (R)  *
+ *    / / / / __/  \__ \  \  /    | |\/| | / _| '_/ _ \| || (__ / _ \      *
+ *   / /_/ / /___ ___/ /  / /     |_|  |_|_\__|_| \___/|_| \___/_/ \_\     *
+ *  /_____/_____//____/  /_/      T  E  C  H  N  O  L  O  G  Y   L A B     *
+ *                                                                         *
+ *          Copyright 2022 Deutsches Elektronen-Synchrotron DESY.          *
+ *                          All rights reserved.                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "fpga_mailbox_layout.h"
+
+/* Snapshot validation
+ *
+ * mb_validate_snapshot() checks a raw snapshot in a single pass and sets one bit per
+ * field (or field group) which holds usable data:
+ *
+ *   MB_VALID_MAGIC              magic string present
+ *   MB_VALID_VERSION            supported mailbox version
+ *   MB_VALID_BOARD_NAME         board name well-formed
+ *   MB_VALID_FPGA_CTRL/STATUS   reserved bits clear
+ *   MB_VALID_FRU_STATUS(f)      reserved bits clear, num_temp_sensors <= MAX_SENS_PER_FRU
+ *   MB_VALID_FRU_TEMP(f, i)     temperature sensor used and not FRU_TEMP_INVALID
+ *   MB_VALID_FRU_STR(f, s)      FRU description string well-formed
+ *   MB_VALID_MMC_SENSOR(i)      sensor named (well-formed) and reading not NaN
+ *
+ * Strings are well-formed if they consist of printable ASCII characters, optionally
+ * followed by zero padding; empty strings are well-formed. Consumers test the result
+ * with mb_is_valid() instead of repeating the checks per field.
+ */
+
+enum mb_fru_str {
+    MB_FRU_MANUFACTURER,
+    MB_FRU_PRODUCT,
+    MB_FRU_PART_NR,
+    MB_FRU_SERIAL_NR,
+    MB_FRU_VERSION,
+    MB_FRU_NUM_STR,
+};
+
+// Bit numbers, groups don't cross 64-bit word boundaries
+enum mb_valid_bit {
+    MB_VALID_MAGIC,
+    MB_VALID_VERSION,
+    MB_VALID_BOARD_NAME,
+    MB_VALID_FPGA_CTRL,
+    MB_VALID_FPGA_STATUS,
+    MB_VALID_FRU_STATUS_0,
+    MB_VALID_FRU_TEMP_0 = MB_VALID_FRU_STATUS_0 + NUM_FRUS,
+    MB_VALID_FRU_STR_0 = MB_VALID_FRU_TEMP_0 + NUM_FRUS * MAX_SENS_PER_FRU,
+    MB_VALID_MMC_SENSOR_0 = 64,
+    MB_VALID_NUM_BITS = MB_VALID_MMC_SENSOR_0 + MAX_SENS_MMC,
+};
+
+#define MB_VALID_FRU_STATUS(fru) (MB_VALID_FRU_STATUS_0 + (fru))
+#define MB_VALID_FRU_TEMP(fru, i) (MB_VALID_FRU_TEMP_0 + (fru) * MAX_SENS_PER_FRU + (i))
+#define MB_VALID_FRU_STR(fru, s) (MB_VALID_FRU_STR_0 + (fru) * MB_FRU_NUM_STR + (s))
+#define MB_VALID_MMC_SENSOR(i) (MB_VALID_MMC_SENSOR_0 + (i))
+
+#define MB_VALID_WORDS ((MB_VALID_NUM_BITS + 63) / 64)
+
+typedef struct mb_validity {
+    uint64_t bits[MB_VALID_WORDS];
+} mb_validity_t;
+
+// Validate raw snapshot <mb>
+void mb_validate_snapshot(const mb_memory_contents_t* mb, mb_validity_t* v);
+
+// Returns true if bit <bit> (enum mb_valid_bit, MB_VALID_xxx()) is set
+static inline bool mb_is_valid(const mb_validity_t* v, unsigned bit)
+{
+    return (v->bits[bit / 64] >> (bit % 64)) & 1;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,165 @@
+/***************************************************************************
+ *      ____  _____________  __    __  __ _           _____ ___   _        *
+ *     / __ \/ ____/ ___/\ \/ /   |  \/  (_)__ _ _ __|_   _/ __| /_\  (R)  *
+ *    / / / / __/  \__ \  \  /    | |\/| | / _| '_/ _ \| || (__ / _ \      *
+ *   / /_/ / /___ ___/ /  / /     |_|  |_|_\__|_| \___/|_| \___/_/ \_\     *
+ *  /_____/_____//____/  /_/      T  E  C  H  N  O  L  O  G  Y   L A B     *
+ *                                                                         *
+ *          Copyright 2022 Deutsches Elektronen-Synchrotron DESY.          *
+ *                          All rights reserved.                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "mmcmb/mmcmb_appdata.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "mmcmb/fpga_mailbox_layout.h"
+
+#define MAGIC_LEN (sizeof(MB_APPDATA_MAGIC) - 1)
+
+bool mb_appdata_has_schema(const uint8_t* data)
+{
+    return !memcmp(data, MB_APPDATA_MAGIC, MAGIC_LEN) && data[MAGIC_LEN] == MB_APPDATA_VERSION;
+}
+
+bool mb_appdata_iter_init(mb_appdata_iter_t* it, const uint8_t* data)
+{
+    it->data = data;
+    it->pos = MB_APPDATA_HDR_SIZE;
+    it->error = false;
+    return mb_appdata_has_schema(data);
+}
+
+bool mb_appdata_next(mb_appdata_iter_t* it, mb_appdata_rec_t* rec)
+{
+    if (it->error || it->pos >= MB_APPDATA_SIZE) {
+        return false;
+    }
+    const uint8_t type = it->data[it->pos];
+    if (type == MB_APPDATA_END || type == MB_APPDATA_ERASED) {
+        return false;
+    }
+    if (it->pos + 2 > MB_APPDATA_SIZE
+        || it->pos + 2 + it->data[it->pos + 1] > MB_APPDATA_SIZE) {
+        it->error = true;
+        return false;
+    }
+    rec->type = type;
+    rec->len = it->data[it->pos + 1];
+    rec->value = &it->data[it->pos + 2];
+    it->pos += 2 + rec->len;
+    return true;
+}
+
+bool mb_appdata_find(const uint8_t* data, uint8_t type, mb_appdata_rec_t* rec)
+{
+    mb_appdata_iter_t it;
+    if (!mb_appdata_iter_init(&it, data)) {
+        return false;
+    }
+    while (mb_appdata_next(&it, rec)) {
+        if (rec->type == type) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint32_t get_le(const uint8_t* p, size_t n)
+{
+    uint32_t val = 0;
+    for (size_t i = 0; i < n; i++) {
+        val |= (uint32_t)p[i] << (8 * i);
+    }
+    return val;
+}
+
+bool mb_appdata_get_u8(const mb_appdata_rec_t* rec, uint8_t* val)
+{
+    if (rec->len != sizeof(*val)) {
+        return false;
+    }
+    *val = rec->value[0];
+    return true;
+}
+
+bool mb_appdata_get_u16(const mb_appdata_rec_t* rec, uint16_t* val)
+{
+    if (rec->len != sizeof(*val)) {
+        return false;
+    }
+    *val = get_le(rec->value, sizeof(*val));
+    return true;
+}
+
+bool mb_appdata_get_u32(const mb_appdata_rec_t* rec, uint32_t* val)
+{
+    if (rec->len != sizeof(*val)) {
+        return false;
+    }
+    *val = get_le(rec->value, sizeof(*val));
+    return true;
+}
+
+bool mb_appdata_get_float(const mb_appdata_rec_t* rec, float* val)
+{
+    uint32_t u;
+    if (!mb_appdata_get_u32(rec, &u)) {
+        return false;
+    }
+    memcpy(val, &u, sizeof(*val));
+    return true;
+}
+
+bool mb_appdata_get_str(const mb_appdata_rec_t* rec, char* buf, size_t len)
+{
+    const size_t n = strnlen((const char*)rec->value, rec->len);
+    if (n >= len) {
+        return false;
+    }
+    memcpy(buf, rec->value, n);
+    buf[n] = '\0';
+    return true;
+}
+
+void mb_appdata_writer_init(mb_appdata_writer_t* w, uint8_t* data)
+{
+    memset(data, 0, MB_APPDATA_SIZE);
+    memcpy(data, MB_APPDATA_MAGIC, MAGIC_LEN);
+    data[MAGIC_LEN] = MB_APPDATA_VERSION;
+    w->data = data;
+    w->pos = MB_APPDATA_HDR_SIZE;
+}
+
+bool mb_appdata_add(mb_appdata_writer_t* w, uint8_t type, const void* value, uint8_t len)
+{
+    if (type == MB_APPDATA_END || type == MB_APPDATA_ERASED
+        || w->pos + 2 + len > MB_APPDATA_SIZE) {
+        return false;
+    }
+    w->data[w->pos] = type;
+    w->data[w->pos + 1] = len;
+    memcpy(&w->data[w->pos + 2], value, len);
+    w->pos += 2 + len;
+    return true;
+}
+
+void mb_appdata_watch_init(mb_appdata_watch_t* w)
+{
+    w->valid = false;
+}
+
+bool mb_appdata_changed(mb_appdata_watch_t* w, const uint8_t* data)
+{
+    // Compare the raw block, the records are only parsed by the caller if it changed
+    if (w->valid && !memcmp(w->data, data, MB_APPDATA_SIZE)) {
+        return false;
+    }
+    memcpy(w->data, data, MB_APPDATA_SIZE);
+    w->valid = true;
+    return true;
+}
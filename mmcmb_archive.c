@@ -0,0 +1,510 @@
+/***************************************************************************
+ *      ____  _____________  __    __  __ _           _____ ___   _        *
+ *     / __ \/ ____/ ___/\ \/ /   |  \/  (_)__ _ _ __|_   _/ __| /_\  (R)  *
+ *    / / / / __/  \__ \  \  /    | |\/| | / _| '_/ _ \| || (__ / _ \      *
+ *   / /_/ / /___ ___/ /  / /     |_|  |_|_\__|_| \___/|_| \___/_/ \_\     *
+ *  /_____/_____//____/  /_/      T  E  C  H  N  O  L  O  G  Y   L A B     *
+ *                                                                         *
+ *          Copyright 2022 Deutsches Elektronen-Synchrotron DESY.          *
+ *                          All rights reserved.                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "mmcmb/mmcmb_archive.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mmcmb/fpga_mailbox_layout.h"
+
+#define SNAPSHOT_SIZE sizeof(mb_memory_contents_t)
+
+// Unchanged gaps shorter than a run header are cheaper to include in the current run
+#define DELTA_MIN_GAP sizeof(mb_archive_run_t)
+
+// Worst case delta is larger than a keyframe, so we fall back to a keyframe then
+#define DELTA_BUF_SIZE SNAPSHOT_SIZE
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wattributes"
+
+// Little-endian 64-bit value outside of the file format structs (index count and offset)
+typedef struct le64 {
+    uint64_t val;
+} MB_PACKED le64_t;
+
+#pragma GCC diagnostic pop
+
+/* Delta helpers */
+
+size_t mb_delta_encode(const void* prev, const void* cur, size_t n, void* out, size_t out_len)
+{
+    const uint8_t* p = prev;
+    const uint8_t* c = cur;
+    uint8_t* o = out;
+    size_t o_len = 0;
+
+    size_t i = 0;
+    while (i < n) {
+        if (p[i] == c[i]) {
+            i++;
+            continue;
+        }
+        // Start of a run, extend it until we find a sufficiently long unchanged gap
+        size_t start = i, end = i + 1;
+        for (size_t k = end; k < n && k - end < DELTA_MIN_GAP; k++) {
+            if (p[k] != c[k]) {
+                end = k + 1;
+            }
+        }
+        const size_t len = end - start;
+        if (o_len + sizeof(mb_archive_run_t) + len > out_len) {
+            return 0;
+        }
+        mb_archive_run_t* run = (mb_archive_run_t*)&o[o_len];
+        run->offs = start;
+        run->len = len;
+        o_len += sizeof(*run);
+        memcpy(&o[o_len], &c[start], len);
+        o_len += len;
+        i = end;
+    }
+    return o_len;
+}
+
+bool mb_delta_apply(void* buf, size_t n, const void* delta, size_t len)
+{
+    uint8_t* b = buf;
+    const uint8_t* d = delta;
+    size_t i = 0;
+
+    while (i < len) {
+        if (len - i < sizeof(mb_archive_run_t)) {
+            return false;
+        }
+        const mb_archive_run_t* run = (const mb_archive_run_t*)&d[i];
+        const size_t offs = run->offs, run_len = run->len;
+        i += sizeof(*run);
+        if (offs + run_len > n || run_len > len - i) {
+            return false;
+        }
+        memcpy(&b[offs], &d[i], run_len);
+        i += run_len;
+    }
+    return true;
+}
+
+/* Writer */
+
+struct mb_archive_writer {
+    FILE* f;
+    unsigned keyframe_interval;
+    unsigned frames_since_keyframe;
+    bool have_prev;
+    uint64_t last_timestamp_ns;
+    mb_memory_contents_t prev;
+    uint8_t delta[DELTA_BUF_SIZE];
+    mb_archive_index_entry_t* index;
+    size_t index_len, index_cap;
+};
+
+mb_archive_writer_t* mb_archive_create(const char* path, unsigned keyframe_interval)
+{
+    mb_archive_writer_t* w = calloc(1, sizeof(*w));
+    if (!w) {
+        perror("calloc");
+        return NULL;
+    }
+    w->keyframe_interval = keyframe_interval ? keyframe_interval : 1;
+
+    // Explicit mode, don't depend on the caller's umask; not inherited by spawned processes
+    const int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0 || !(w->f = fdopen(fd, "wb"))) {
+        fprintf(stderr, "Could not create %s: %s\n", path, strerror(errno));
+        if (fd >= 0) {
+            close(fd);
+        }
+        free(w);
+        return NULL;
+    }
+
+    mb_archive_header_t hdr = {
+        .format_version = MB_ARCHIVE_FORMAT_VERSION,
+        .snapshot_size = SNAPSHOT_SIZE,
+        .keyframe_interval = w->keyframe_interval,
+    };
+    memcpy(hdr.magic, MB_ARCHIVE_MAGIC, sizeof(hdr.magic));
+    if (fwrite(&hdr, sizeof(hdr), 1, w->f) != 1) {
+        perror("write error");
+        fclose(w->f);
+        free(w);
+        return NULL;
+    }
+    return w;
+}
+
+static bool index_add(mb_archive_writer_t* w, uint64_t timestamp_ns, uint64_t frame_offs)
+{
+    if (w->index_len == w->index_cap) {
+        const size_t cap = w->index_cap ? w->index_cap * 2 : 64;
+        mb_archive_index_entry_t* idx = realloc(w->index, cap * sizeof(*idx));
+        if (!idx) {
+            perror("realloc");
+            return false;
+        }
+        w->index = idx;
+        w->index_cap = cap;
+    }
+    w->index[w->index_len++] = (mb_archive_index_entry_t){
+        .timestamp_ns = timestamp_ns,
+        .frame_offs = frame_offs,
+    };
+    return true;
+}
+
+bool mb_archive_append(mb_archive_writer_t* w,
+                       uint64_t timestamp_ns,
+                       const mb_memory_contents_t* snap)
+{
+    if (w->have_prev && timestamp_ns < w->last_timestamp_ns) {
+        fprintf(stderr, "Archive timestamps must be monotonic\n");
+        return false;
+    }
+
+    mb_archive_frame_t frame = {
+        .magic = MB_ARCHIVE_FRAME_MAGIC,
+        .type = MB_ARCHIVE_DELTA,
+        .timestamp_ns = timestamp_ns,
+    };
+    const void* payload = w->delta;
+
+    if (w->have_prev && w->frames_since_keyframe < w->keyframe_interval) {
+        frame.payload_len = mb_delta_encode(&w->prev, snap, SNAPSHOT_SIZE, w->delta, DELTA_BUF_SIZE);
+        if (frame.payload_len == 0 && memcmp(&w->prev, snap, SNAPSHOT_SIZE)) {
+            // Delta larger than a keyframe
+            frame.type = MB_ARCHIVE_KEYFRAME;
+        }
+    } else {
+        frame.type = MB_ARCHIVE_KEYFRAME;
+    }
+
+    if (frame.type == MB_ARCHIVE_KEYFRAME) {
+        frame.payload_len = SNAPSHOT_SIZE;
+        payload = snap;
+        const off_t offs = ftello(w->f);
+        if (offs < 0) {
+            perror("tell error");
+            return false;
+        }
+        if (!index_add(w, timestamp_ns, offs)) {
+            return false;
+        }
+        w->frames_since_keyframe = 0;
+    }
+
+    if (fwrite(&frame, sizeof(frame), 1, w->f) != 1 ||
+        (frame.payload_len && fwrite(payload, frame.payload_len, 1, w->f) != 1)) {
+        perror("write error");
+        return false;
+    }
+
+    w->frames_since_keyframe++;
+    w->last_timestamp_ns = timestamp_ns;
+    w->have_prev = true;
+    memcpy(&w->prev, snap, SNAPSHOT_SIZE);
+    return true;
+}
+
+bool mb_archive_finish(mb_archive_writer_t* w)
+{
+    bool ok = false;
+    const off_t offs = ftello(w->f);
+    const le64_t index_offs = {offs};
+    const le64_t count = {w->index_len};
+
+    if (offs < 0) {
+        // Leave the archive unfinished, readers rebuild the index by a scan
+        perror("tell error");
+        goto out;
+    }
+    if (fwrite(&count, sizeof(count), 1, w->f) != 1 ||
+        (count.val && fwrite(w->index, sizeof(*w->index), count.val, w->f) != count.val)) {
+        perror("write error");
+        goto out;
+    }
+    if (fflush(w->f) || pwrite(fileno(w->f),
+                               &index_offs,
+                               sizeof(index_offs),
+                               offsetof(mb_archive_header_t, index_offs)) != sizeof(index_offs)) {
+        perror("write error");
+        goto out;
+    }
+    ok = true;
+
+out:
+    if (fclose(w->f)) {
+        perror("close error");
+        ok = false;
+    }
+    free(w->index);
+    free(w);
+    return ok;
+}
+
+/* Reader */
+
+struct mb_archive {
+    const uint8_t* map;
+    size_t map_len;
+    size_t frames_end;
+    const mb_archive_index_entry_t* index;
+    size_t index_len;
+    mb_archive_index_entry_t* scanned_index;  // Rebuilt index for unfinished archives
+    uint64_t last_timestamp_ns;
+};
+
+// Returns the frame at <offs> or NULL if it is truncated or corrupt
+static const mb_archive_frame_t* frame_at(const mb_archive_t* ar, size_t offs)
+{
+    // frames_end is at least the header size, so this can't wrap around
+    if (offs > ar->frames_end - sizeof(mb_archive_frame_t)) {
+        return NULL;
+    }
+    const mb_archive_frame_t* frame = (const mb_archive_frame_t*)&ar->map[offs];
+    if (frame->magic != MB_ARCHIVE_FRAME_MAGIC ||
+        frame->payload_len > ar->frames_end - offs - sizeof(*frame)) {
+        return NULL;
+    }
+    if (frame->type == MB_ARCHIVE_KEYFRAME ? frame->payload_len != SNAPSHOT_SIZE
+                                           : frame->type != MB_ARCHIVE_DELTA) {
+        return NULL;
+    }
+    return frame;
+}
+
+static size_t next_frame_offs(const mb_archive_frame_t* frame, size_t offs)
+{
+    return offs + sizeof(*frame) + frame->payload_len;
+}
+
+// Linear scan over all frames, used if the archive has no index
+static bool scan_index(mb_archive_t* ar)
+{
+    size_t cap = 0;
+    size_t offs = sizeof(mb_archive_header_t);
+    const mb_archive_frame_t* frame;
+
+    while ((frame = frame_at(ar, offs)) != NULL) {
+        if (frame->type == MB_ARCHIVE_KEYFRAME) {
+            if (ar->index_len == cap) {
+                cap = cap ? cap * 2 : 64;
+                mb_archive_index_entry_t* idx = realloc(ar->scanned_index, cap * sizeof(*idx));
+                if (!idx) {
+                    perror("realloc");
+                    return false;
+                }
+                ar->scanned_index = idx;
+            }
+            ar->scanned_index[ar->index_len++] = (mb_archive_index_entry_t){
+                .timestamp_ns = frame->timestamp_ns,
+                .frame_offs = offs,
+            };
+        }
+        offs = next_frame_offs(frame, offs);
+    }
+    // Drop a truncated last frame
+    ar->frames_end = offs;
+    ar->index = ar->scanned_index;
+    return true;
+}
+
+// Check the index read from the file: entries in file order, each pointing at a keyframe
+static bool index_valid(const mb_archive_t* ar)
+{
+    size_t prev_offs = 0;
+    for (size_t i = 0; i < ar->index_len; i++) {
+        const mb_archive_index_entry_t* e = &ar->index[i];
+        if (e->frame_offs < sizeof(mb_archive_header_t) || e->frame_offs >= ar->frames_end ||
+            (i && e->frame_offs <= prev_offs)) {
+            return false;
+        }
+        const mb_archive_frame_t* frame = frame_at(ar, e->frame_offs);
+        if (!frame || frame->type != MB_ARCHIVE_KEYFRAME ||
+            frame->timestamp_ns != e->timestamp_ns) {
+            return false;
+        }
+        prev_offs = e->frame_offs;
+    }
+    return true;
+}
+
+mb_archive_t* mb_archive_open(const char* path)
+{
+    mb_archive_t* ar = calloc(1, sizeof(*ar));
+    if (!ar) {
+        perror("calloc");
+        return NULL;
+    }
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        fprintf(stderr, "Could not open %s: %s\n", path, strerror(errno));
+        goto err_free;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        fprintf(stderr, "Could not stat %s: %s\n", path, strerror(errno));
+        goto err_close;
+    }
+    if ((size_t)st.st_size < sizeof(mb_archive_header_t)) {
+        fprintf(stderr, "%s: not a mailbox archive\n", path);
+        goto err_close;
+    }
+    ar->map_len = st.st_size;
+    void* map = mmap(NULL, ar->map_len, PROT_READ, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "Could not map %s: %s\n", path, strerror(errno));
+        goto err_close;
+    }
+    close(fd);
+    ar->map = map;
+    // Queries jump to a keyframe and read forward from there, so don't read ahead the whole file
+    madvise(map, ar->map_len, MADV_RANDOM);
+
+    const mb_archive_header_t* hdr = (const mb_archive_header_t*)ar->map;
+    if (memcmp(hdr->magic, MB_ARCHIVE_MAGIC, sizeof(hdr->magic)) ||
+        hdr->format_version != MB_ARCHIVE_FORMAT_VERSION || hdr->snapshot_size != SNAPSHOT_SIZE) {
+        fprintf(stderr, "%s: not a mailbox archive or unsupported format\n", path);
+        goto err_unmap;
+    }
+
+    const uint64_t index_offs = hdr->index_offs;
+    uint64_t count = UINT64_MAX;
+    if (index_offs >= sizeof(*hdr) && index_offs + sizeof(le64_t) <= ar->map_len) {
+        le64_t count_le;
+        memcpy(&count_le, &ar->map[index_offs], sizeof(count_le));
+        count = count_le.val;
+    }
+    if (count <= (ar->map_len - index_offs - sizeof(le64_t)) / sizeof(mb_archive_index_entry_t)) {
+        ar->frames_end = index_offs;
+        ar->index = (const mb_archive_index_entry_t*)&ar->map[index_offs + sizeof(le64_t)];
+        ar->index_len = count;
+        if (!index_valid(ar)) {
+            fprintf(stderr, "%s: index corrupt, rebuilding it\n", path);
+            ar->index = NULL;
+            ar->index_len = 0;
+            ar->frames_end = ar->map_len;
+        }
+    } else {
+        ar->frames_end = ar->map_len;
+    }
+    if (!ar->index && !scan_index(ar)) {
+        goto err_unmap;
+    }
+
+    // Walk the frames after the last keyframe to find the end of the time range
+    if (ar->index_len) {
+        size_t offs = ar->index[ar->index_len - 1].frame_offs;
+        const mb_archive_frame_t* frame;
+        while ((frame = frame_at(ar, offs)) != NULL) {
+            ar->last_timestamp_ns = frame->timestamp_ns;
+            offs = next_frame_offs(frame, offs);
+        }
+    }
+    return ar;
+
+err_unmap:
+    munmap((void*)ar->map, ar->map_len);
+    free(ar->scanned_index);
+    free(ar);
+    return NULL;
+err_close:
+    close(fd);
+err_free:
+    free(ar);
+    return NULL;
+}
+
+void mb_archive_close(mb_archive_t* ar)
+{
+    if (!ar) {
+        return;
+    }
+    munmap((void*)ar->map, ar->map_len);
+    free(ar->scanned_index);
+    free(ar);
+}
+
+size_t mb_archive_num_keyframes(const mb_archive_t* ar)
+{
+    return ar->index_len;
+}
+
+uint64_t mb_archive_first_timestamp(const mb_archive_t* ar)
+{
+    return ar->index_len ? ar->index[0].timestamp_ns : 0;
+}
+
+uint64_t mb_archive_last_timestamp(const mb_archive_t* ar)
+{
+    return ar->last_timestamp_ns;
+}
+
+bool mb_archive_query(const mb_archive_t* ar,
+                      uint64_t t0_ns,
+                      uint64_t t1_ns,
+                      mb_archive_cb_t cb,
+                      void* arg)
+{
+    if (!ar->index_len || t1_ns < t0_ns) {
+        return true;
+    }
+
+    // Binary search for the last keyframe before t0 (or the first keyframe). Not at t0:
+    // delta frames preceding a keyframe can share its timestamp and must be reported too.
+    size_t lo = 0, hi = ar->index_len;
+    while (hi - lo > 1) {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (ar->index[mid].timestamp_ns < t0_ns) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+
+    mb_memory_contents_t snap;
+    size_t offs = ar->index[lo].frame_offs;
+    const mb_archive_frame_t* frame;
+
+    while (offs < ar->frames_end) {
+        frame = frame_at(ar, offs);
+        if (!frame) {
+            fprintf(stderr, "Archive corrupt at offset %zu\n", offs);
+            return false;
+        }
+        if (frame->timestamp_ns > t1_ns) {
+            break;
+        }
+        const uint8_t* payload = (const uint8_t*)(frame + 1);
+        if (frame->type == MB_ARCHIVE_KEYFRAME) {
+            memcpy(&snap, payload, SNAPSHOT_SIZE);
+        } else if (!mb_delta_apply(&snap, SNAPSHOT_SIZE, payload, frame->payload_len)) {
+            fprintf(stderr, "Archive corrupt at offset %zu\n", offs);
+            return false;
+        }
+        if (frame->timestamp_ns >= t0_ns && !cb(frame->timestamp_ns, &snap, arg)) {
+            break;
+        }
+        offs = next_frame_offs(frame, offs);
+    }
+    return true;
+}
@@ -0,0 +1,144 @@
+/***************************************************************************
+ *      ____  _____________  __    __  __ _           _____ ___   _        *
+ *     / __ \/ ____/ ___/\ \/ /   |  \/  (_)__ _ _ __|_   _/ __| /_\  (R)  *
+ *    / / / / __/  \__ \  \  /    | |\/| | / _| '_/ _ \| || (__ / _ \      *
+ *   / /_/ / /___ ___/ /  / /     |_|  |_|_\__|_| \___/|_| \___/_/ \_\     *
+ *  /_____/_____//____/  /_/      T  E  C  H  N  O  L  O  G  Y   L A B     *
+ *                                                                         *
+ *          Copyright 2022 Deutsches Elektronen-Synchrotron DESY.          *
+ *                          All rights reserved.                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "mmcmb/mmcmb_decode.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "mmcmb/fpga_mailbox_layout.h"
+#include "mmcmb/mmcmb.h"
+
+// Copy a fixed-size, possibly unterminated string and terminate it
+#define COPY_STR(dst, src)                                                  \
+    do {                                                                    \
+        static_assert(sizeof(dst) > sizeof(src), "Destination too small"); \
+        memcpy((dst), (src), sizeof(src));                                  \
+        (dst)[sizeof(src)] = '\0';                                          \
+    } while (0)
+
+static void decode_fru_status(const mb_fru_status_t* raw, mb_fru_status_decoded_t* dec)
+{
+    dec->present = raw->present;
+    dec->compatible = raw->compatible;
+    dec->powered = raw->powered;
+    dec->failure = raw->failure;
+    dec->hspc_prsnt = raw->ext.fmc.hspc_prsnt;
+    dec->clk_dir = raw->ext.fmc.clk_dir;
+    dec->pg_m2c = raw->ext.fmc.pg_m2c;
+
+    const size_t n = raw->num_temp_sensors < MAX_SENS_PER_FRU ? raw->num_temp_sensors
+                                                              : MAX_SENS_PER_FRU;
+    dec->num_temp_sensors = n;
+    for (size_t i = 0; i < MAX_SENS_PER_FRU; i++) {
+        const uint16_t t = raw->temperature[i];
+        // Temperatures are s16 in 0.01 deg. C increments
+        dec->temperature[i] = (i < n && t != FRU_TEMP_INVALID) ? (float)(int16_t)t / 100.f : NAN;
+    }
+}
+
+static void decode_version(const mb_version_number_t* raw, mb_version_decoded_t* dec)
+{
+    dec->major = raw->major;
+    dec->minor = raw->minor;
+}
+
+static void decode_mmc_information(const mb_mmc_information_t* raw,
+                                   mb_mmc_information_decoded_t* dec)
+{
+    decode_version(&raw->application_version, &dec->application_version);
+    decode_version(&raw->library_version, &dec->library_version);
+    decode_version(&raw->cpld_board_version, &dec->cpld_board_version);
+    decode_version(&raw->cpld_library_version, &dec->cpld_library_version);
+    dec->stamp_hw_revision = raw->stamp_hw_revision;
+    dec->amc_slot_nr = raw->amc_slot_nr;
+    dec->ipmb_addr = raw->ipmb_addr;
+    COPY_STR(dec->board_name, raw->board_name);
+    dec->vendor_id = raw->vendor_id;
+    dec->product_id = raw->product_id;
+    dec->mmc_uptime = raw->mmc_uptime;
+    dec->amc_hw_revision = raw->amc_hw_revision;
+}
+
+static void decode(const mb_version_desc_t* desc,
+                   const mb_memory_contents_t* raw,
+                   mb_decoded_t* dec)
+{
+    // Fields the mailbox version doesn't define are decoded as zero
+    mb_memory_contents_t cleared;
+    if (desc->num_undefined) {
+        cleared = *raw;
+        mb_clear_undefined(desc, &cleared, 0, sizeof(cleared));
+        raw = &cleared;
+    }
+
+    dec->mailbox_version = raw->mailbox_version;
+
+    for (size_t i = 0; i < NUM_FRUS; i++) {
+        decode_fru_status(&raw->fru_information[i].status, &dec->fru_status[i]);
+    }
+
+    decode_mmc_information(&raw->mmc_information, &dec->mmc_information);
+
+    dec->num_mmc_sensors = MAX_SENS_MMC;
+    for (size_t i = 0; i < MAX_SENS_MMC; i++) {
+        const mb_mmc_sensor_t* sen = &raw->mmc_sensor[i];
+        COPY_STR(dec->mmc_sensor[i].name, sen->name);
+        dec->mmc_sensor[i].reading = sen->reading;
+        if (!sen->name[0] && dec->num_mmc_sensors == MAX_SENS_MMC) {
+            dec->num_mmc_sensors = i;
+        }
+    }
+}
+
+static const mb_version_desc_t* find_version(unsigned version)
+{
+    const mb_version_desc_t* desc = mb_get_version_desc(version);
+    if (!desc) {
+        fprintf(stderr, "Unsupported mailbox version %u\n", version);
+    }
+    return desc;
+}
+
+bool mb_decode_snapshot(const mb_memory_contents_t* raw, mb_decoded_t* dec)
+{
+    const mb_version_desc_t* desc = find_version(raw->mailbox_version);
+    if (!desc) {
+        return false;
+    }
+    decode(desc, raw, dec);
+    return true;
+}
+
+bool mb_get_decoded(mb_decoded_t* dec)
+{
+    // The mailbox version is fixed when the mailbox is opened, so look it up only once
+    static const mb_version_desc_t* desc = NULL;
+    if (!desc) {
+        // mb_get_version() reports why the mailbox couldn't be opened
+        const unsigned version = mb_get_version();
+        if (!version || !(desc = find_version(version))) {
+            return false;
+        }
+    }
+
+    mb_memory_contents_t raw;
+    if (!mb_get_snapshot(&raw)) {
+        return false;
+    }
+    decode(desc, &raw, dec);
+    return true;
+}
@@ -0,0 +1,411 @@
+/***************************************************************************
+ *      ____  _____________  __    __  __ _           _____ ___   _        *
+ *     / __ \/ ____/ ___/\ \/ /   |  \/  (_)__ _ _ __|_   _/ __| /_\  (R)  *
+ *    / / / / __/  \__ \  \  /    | |\/| | / _| '_/ _ \| || (__ / _ \      *
+ *   / /_/ / /___ ___/ /  / /     |_|  |_|_\__|_| \___/|_| \___/_/ \_\     *
+ *  /_____/_____//____/  /_/      T  E  C  H  N  O  L  O  G  Y   L A B     *
+ *                                                                         *
+ *          Copyright 2022 Deutsches Elektronen-Synchrotron DESY.          *
+ *                          All rights reserved.                           *
+ *                                                                         *
+ ***************************************************************************/
+
+/* Generated from doc/mmc-fpga-data-interface.ods by doc/ods2layout.py, do not edit */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "mmcmb/fpga_mailbox_layout.h"
+
+#define NUM_ELEMS(x) (sizeof(x) / sizeof((x)[0]))
+
+static const mb_field_desc_t fields_v2[] = {
+    {"mailbox_magic_str", 0, 7, MB_FIELD_CHAR},
+    {"mailbox_version", 7, 1, MB_FIELD_U8},
+    {"fru_information[0].status.flags", 8, 1, MB_FIELD_BITS},
+    {"fru_information[0].status.num_temp_sensors", 9, 1, MB_FIELD_U8},
+    {"fru_information[0].status.temperature[0]", 10, 2, MB_FIELD_S16},
+    {"fru_information[0].status.temperature[1]", 12, 2, MB_FIELD_S16},
+    {"fru_information[0].status.temperature[2]", 14, 2, MB_FIELD_S16},
+    {"fru_information[0].status.temperature[3]", 16, 2, MB_FIELD_S16},
+    {"fru_information[0].status.temperature[4]", 18, 2, MB_FIELD_S16},
+    {"fru_information[0].status.temperature[5]", 20, 2, MB_FIELD_S16},
+    {"fru_information[0].status.temperature[6]", 22, 2, MB_FIELD_S16},
+    {"fru_information[0].status.temperature[7]", 24, 2, MB_FIELD_S16},
+    {"fru_information[0].status.ext", 26, 2, MB_FIELD_RAW},
+    {"fru_information[0].description.uid", 28, 6, MB_FIELD_U8},
+    {"fru_information[0].description.manufacturer", 34, 60, MB_FIELD_CHAR},
+    {"fru_information[0].description.product", 94, 60, MB_FIELD_CHAR},
+    {"fru_information[0].description.part_nr", 154, 60, MB_FIELD_CHAR},
+    {"fru_information[0].description.serial_nr", 214, 30, MB_FIELD_CHAR},
+    {"fru_information[0].description.version", 244, 20, MB_FIELD_CHAR},
+    {"fru_information[1].status.flags", 264, 1, MB_FIELD_BITS},
+    {"fru_information[1].status.num_temp_sensors", 265, 1, MB_FIELD_U8},
+    {"fru_information[1].status.temperature[0]", 266, 2, MB_FIELD_S16},
+    {"fru_information[1].status.temperature[1]", 268, 2, MB_FIELD_S16},
+    {"fru_information[1].status.temperature[2]", 270, 2, MB_FIELD_S16},
+    {"fru_information[1].status.temperature[3]", 272, 2, MB_FIELD_S16},
+    {"fru_information[1].status.temperature[4]", 274, 2, MB_FIELD_S16},
+    {"fru_information[1].status.temperature[5]", 276, 2, MB_FIELD_S16},
+    {"fru_information[1].status.temperature[6]", 278, 2, MB_FIELD_S16},
+    {"fru_information[1].status.temperature[7]", 280, 2, MB_FIELD_S16},
+    {"fru_information[1].status.ext", 282, 2, MB_FIELD_RAW},
+    {"fru_information[1].description.uid", 284, 6, MB_FIELD_U8},
+    {"fru_information[1].description.manufacturer", 290, 60, MB_FIELD_CHAR},
+    {"fru_information[1].description.product", 350, 60, MB_FIELD_CHAR},
+    {"fru_information[1].description.part_nr", 410, 60, MB_FIELD_CHAR},
+    {"fru_information[1].description.serial_nr", 470, 30, MB_FIELD_CHAR},
+    {"fru_information[1].description.version", 500, 20, MB_FIELD_CHAR},
+    {"fru_information[2].status.flags", 520, 1, MB_FIELD_BITS},
+    {"fru_information[2].status.num_temp_sensors", 521, 1, MB_FIELD_U8},
+    {"fru_information[2].status.temperature[0]", 522, 2, MB_FIELD_S16},
+    {"fru_information[2].status.temperature[1]", 524, 2, MB_FIELD_S16},
+    {"fru_information[2].status.temperature[2]", 526, 2, MB_FIELD_S16},
+    {"fru_information[2].status.temperature[3]", 528, 2, MB_FIELD_S16},
+    {"fru_information[2].status.temperature[4]", 530, 2, MB_FIELD_S16},
+    {"fru_information[2].status.temperature[5]", 532, 2, MB_FIELD_S16},
+    {"fru_information[2].status.temperature[6]", 534, 2, MB_FIELD_S16},
+    {"fru_information[2].status.temperature[7]", 536, 2, MB_FIELD_S16},
+    {"fru_information[2].status.ext", 538, 2, MB_FIELD_RAW},
+    {"fru_information[2].description.uid", 540, 6, MB_FIELD_U8},
+    {"fru_information[2].description.manufacturer", 546, 60, MB_FIELD_CHAR},
+    {"fru_information[2].description.product", 606, 60, MB_FIELD_CHAR},
+    {"fru_information[2].description.part_nr", 666, 60, MB_FIELD_CHAR},
+    {"fru_information[2].description.serial_nr", 726, 30, MB_FIELD_CHAR},
+    {"fru_information[2].description.version", 756, 20, MB_FIELD_CHAR},
+    {"fru_information[3].status.flags", 776, 1, MB_FIELD_BITS},
+    {"fru_information[3].status.num_temp_sensors", 777, 1, MB_FIELD_U8},
+    {"fru_information[3].status.temperature[0]", 778, 2, MB_FIELD_S16},
+    {"fru_information[3].status.temperature[1]", 780, 2, MB_FIELD_S16},
+    {"fru_information[3].status.temperature[2]", 782, 2, MB_FIELD_S16},
+    {"fru_information[3].status.temperature[3]", 784, 2, MB_FIELD_S16},
+    {"fru_information[3].status.temperature[4]", 786, 2, MB_FIELD_S16},
+    {"fru_information[3].status.temperature[5]", 788, 2, MB_FIELD_S16},
+    {"fru_information[3].status.temperature[6]", 790, 2, MB_FIELD_S16},
+    {"fru_information[3].status.temperature[7]", 792, 2, MB_FIELD_S16},
+    {"fru_information[3].status.ext", 794, 2, MB_FIELD_RAW},
+    {"fru_information[3].description.uid", 796, 6, MB_FIELD_U8},
+    {"fru_information[3].description.manufacturer", 802, 60, MB_FIELD_CHAR},
+    {"fru_information[3].description.product", 862, 60, MB_FIELD_CHAR},
+    {"fru_information[3].description.part_nr", 922, 60, MB_FIELD_CHAR},
+    {"fru_information[3].description.serial_nr", 982, 30, MB_FIELD_CHAR},
+    {"fru_information[3].description.version", 1012, 20, MB_FIELD_CHAR},
+    {"application_data", 1032, 256, MB_FIELD_RAW},
+    {"mmc_information.application_version.major", 1288, 1, MB_FIELD_U8},
+    {"mmc_information.application_version.minor", 1289, 1, MB_FIELD_U8},
+    {"mmc_information.library_version.major", 1290, 1, MB_FIELD_U8},
+    {"mmc_information.library_version.minor", 1291, 1, MB_FIELD_U8},
+    {"mmc_information.cpld_board_version.major", 1292, 1, MB_FIELD_U8},
+    {"mmc_information.cpld_board_version.minor", 1293, 1, MB_FIELD_U8},
+    {"mmc_information.cpld_library_version.major", 1294, 1, MB_FIELD_U8},
+    {"mmc_information.cpld_library_version.minor", 1295, 1, MB_FIELD_U8},
+    {"mmc_information.stamp_hw_revision", 1296, 1, MB_FIELD_CHAR},
+    {"mmc_information.amc_slot_nr", 1297, 1, MB_FIELD_U8},
+    {"mmc_information.ipmb_addr", 1298, 1, MB_FIELD_U8},
+    {"mmc_information.board_name", 1299, 23, MB_FIELD_CHAR},
+    {"mmc_information.vendor_id", 1322, 2, MB_FIELD_U16},
+    {"mmc_information.product_id", 1324, 2, MB_FIELD_U16},
+    {"mmc_information.mmc_uptime", 1326, 4, MB_FIELD_U32},
+    {"mmc_information.reserved", 1330, 6, MB_FIELD_RAW},
+    {"mmc_sensor[0].name", 1336, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[0].reading", 1348, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[1].name", 1352, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[1].reading", 1364, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[2].name", 1368, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[2].reading", 1380, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[3].name", 1384, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[3].reading", 1396, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[4].name", 1400, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[4].reading", 1412, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[5].name", 1416, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[5].reading", 1428, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[6].name", 1432, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[6].reading", 1444, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[7].name", 1448, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[7].reading", 1460, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[8].name", 1464, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[8].reading", 1476, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[9].name", 1480, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[9].reading", 1492, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[10].name", 1496, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[10].reading", 1508, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[11].name", 1512, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[11].reading", 1524, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[12].name", 1528, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[12].reading", 1540, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[13].name", 1544, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[13].reading", 1556, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[14].name", 1560, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[14].reading", 1572, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[15].name", 1576, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[15].reading", 1588, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[16].name", 1592, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[16].reading", 1604, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[17].name", 1608, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[17].reading", 1620, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[18].name", 1624, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[18].reading", 1636, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[19].name", 1640, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[19].reading", 1652, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[20].name", 1656, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[20].reading", 1668, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[21].name", 1672, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[21].reading", 1684, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[22].name", 1688, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[22].reading", 1700, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[23].name", 1704, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[23].reading", 1716, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[24].name", 1720, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[24].reading", 1732, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[25].name", 1736, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[25].reading", 1748, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[26].name", 1752, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[26].reading", 1764, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[27].name", 1768, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[27].reading", 1780, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[28].name", 1784, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[28].reading", 1796, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[29].name", 1800, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[29].reading", 1812, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[30].name", 1816, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[30].reading", 1828, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[31].name", 1832, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[31].reading", 1844, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[32].name", 1848, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[32].reading", 1860, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[33].name", 1864, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[33].reading", 1876, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[34].name", 1880, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[34].reading", 1892, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[35].name", 1896, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[35].reading", 1908, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[36].name", 1912, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[36].reading", 1924, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[37].name", 1928, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[37].reading", 1940, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[38].name", 1944, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[38].reading", 1956, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[39].name", 1960, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[39].reading", 1972, 4, MB_FIELD_FLOAT},
+    {"reserved", 1976, 43, MB_FIELD_RAW},
+    {"bp_eth_info.mac_addr", 2019, 6, MB_FIELD_U8},
+    {"bp_eth_info.ipv4_addr", 2025, 4, MB_FIELD_U8},
+    {"bp_eth_info.ipv6_addr", 2029, 16, MB_FIELD_U8},
+    {"fpga_ctrl", 2045, 1, MB_FIELD_BITS},
+    {"fpga_status", 2046, 1, MB_FIELD_BITS},
+};
+
+static const mb_field_desc_t undefined_v2[] = {
+    {"mmc_information.amc_hw_revision", 1330, 1, MB_FIELD_CHAR},
+};
+
+static const mb_field_desc_t fields_v3[] = {
+    {"mailbox_magic_str", 0, 7, MB_FIELD_CHAR},
+    {"mailbox_version", 7, 1, MB_FIELD_U8},
+    {"fru_information[0].status.flags", 8, 1, MB_FIELD_BITS},
+    {"fru_information[0].status.num_temp_sensors", 9, 1, MB_FIELD_U8},
+    {"fru_information[0].status.temperature[0]", 10, 2, MB_FIELD_S16},
+    {"fru_information[0].status.temperature[1]", 12, 2, MB_FIELD_S16},
+    {"fru_information[0].status.temperature[2]", 14, 2, MB_FIELD_S16},
+    {"fru_information[0].status.temperature[3]", 16, 2, MB_FIELD_S16},
+    {"fru_information[0].status.temperature[4]", 18, 2, MB_FIELD_S16},
+    {"fru_information[0].status.temperature[5]", 20, 2, MB_FIELD_S16},
+    {"fru_information[0].status.temperature[6]", 22, 2, MB_FIELD_S16},
+    {"fru_information[0].status.temperature[7]", 24, 2, MB_FIELD_S16},
+    {"fru_information[0].status.ext", 26, 2, MB_FIELD_RAW},
+    {"fru_information[0].description.uid", 28, 6, MB_FIELD_U8},
+    {"fru_information[0].description.manufacturer", 34, 60, MB_FIELD_CHAR},
+    {"fru_information[0].description.product", 94, 60, MB_FIELD_CHAR},
+    {"fru_information[0].description.part_nr", 154, 60, MB_FIELD_CHAR},
+    {"fru_information[0].description.serial_nr", 214, 30, MB_FIELD_CHAR},
+    {"fru_information[0].description.version", 244, 20, MB_FIELD_CHAR},
+    {"fru_information[1].status.flags", 264, 1, MB_FIELD_BITS},
+    {"fru_information[1].status.num_temp_sensors", 265, 1, MB_FIELD_U8},
+    {"fru_information[1].status.temperature[0]", 266, 2, MB_FIELD_S16},
+    {"fru_information[1].status.temperature[1]", 268, 2, MB_FIELD_S16},
+    {"fru_information[1].status.temperature[2]", 270, 2, MB_FIELD_S16},
+    {"fru_information[1].status.temperature[3]", 272, 2, MB_FIELD_S16},
+    {"fru_information[1].status.temperature[4]", 274, 2, MB_FIELD_S16},
+    {"fru_information[1].status.temperature[5]", 276, 2, MB_FIELD_S16},
+    {"fru_information[1].status.temperature[6]", 278, 2, MB_FIELD_S16},
+    {"fru_information[1].status.temperature[7]", 280, 2, MB_FIELD_S16},
+    {"fru_information[1].status.ext", 282, 2, MB_FIELD_RAW},
+    {"fru_information[1].description.uid", 284, 6, MB_FIELD_U8},
+    {"fru_information[1].description.manufacturer", 290, 60, MB_FIELD_CHAR},
+    {"fru_information[1].description.product", 350, 60, MB_FIELD_CHAR},
+    {"fru_information[1].description.part_nr", 410, 60, MB_FIELD_CHAR},
+    {"fru_information[1].description.serial_nr", 470, 30, MB_FIELD_CHAR},
+    {"fru_information[1].description.version", 500, 20, MB_FIELD_CHAR},
+    {"fru_information[2].status.flags", 520, 1, MB_FIELD_BITS},
+    {"fru_information[2].status.num_temp_sensors", 521, 1, MB_FIELD_U8},
+    {"fru_information[2].status.temperature[0]", 522, 2, MB_FIELD_S16},
+    {"fru_information[2].status.temperature[1]", 524, 2, MB_FIELD_S16},
+    {"fru_information[2].status.temperature[2]", 526, 2, MB_FIELD_S16},
+    {"fru_information[2].status.temperature[3]", 528, 2, MB_FIELD_S16},
+    {"fru_information[2].status.temperature[4]", 530, 2, MB_FIELD_S16},
+    {"fru_information[2].status.temperature[5]", 532, 2, MB_FIELD_S16},
+    {"fru_information[2].status.temperature[6]", 534, 2, MB_FIELD_S16},
+    {"fru_information[2].status.temperature[7]", 536, 2, MB_FIELD_S16},
+    {"fru_information[2].status.ext", 538, 2, MB_FIELD_RAW},
+    {"fru_information[2].description.uid", 540, 6, MB_FIELD_U8},
+    {"fru_information[2].description.manufacturer", 546, 60, MB_FIELD_CHAR},
+    {"fru_information[2].description.product", 606, 60, MB_FIELD_CHAR},
+    {"fru_information[2].description.part_nr", 666, 60, MB_FIELD_CHAR},
+    {"fru_information[2].description.serial_nr", 726, 30, MB_FIELD_CHAR},
+    {"fru_information[2].description.version", 756, 20, MB_FIELD_CHAR},
+    {"fru_information[3].status.flags", 776, 1, MB_FIELD_BITS},
+    {"fru_information[3].status.num_temp_sensors", 777, 1, MB_FIELD_U8},
+    {"fru_information[3].status.temperature[0]", 778, 2, MB_FIELD_S16},
+    {"fru_information[3].status.temperature[1]", 780, 2, MB_FIELD_S16},
+    {"fru_information[3].status.temperature[2]", 782, 2, MB_FIELD_S16},
+    {"fru_information[3].status.temperature[3]", 784, 2, MB_FIELD_S16},
+    {"fru_information[3].status.temperature[4]", 786, 2, MB_FIELD_S16},
+    {"fru_information[3].status.temperature[5]", 788, 2, MB_FIELD_S16},
+    {"fru_information[3].status.temperature[6]", 790, 2, MB_FIELD_S16},
+    {"fru_information[3].status.temperature[7]", 792, 2, MB_FIELD_S16},
+    {"fru_information[3].status.ext", 794, 2, MB_FIELD_RAW},
+    {"fru_information[3].description.uid", 796, 6, MB_FIELD_U8},
+    {"fru_information[3].description.manufacturer", 802, 60, MB_FIELD_CHAR},
+    {"fru_information[3].description.product", 862, 60, MB_FIELD_CHAR},
+    {"fru_information[3].description.part_nr", 922, 60, MB_FIELD_CHAR},
+    {"fru_information[3].description.serial_nr", 982, 30, MB_FIELD_CHAR},
+    {"fru_information[3].description.version", 1012, 20, MB_FIELD_CHAR},
+    {"application_data", 1032, 256, MB_FIELD_RAW},
+    {"mmc_information.application_version.major", 1288, 1, MB_FIELD_U8},
+    {"mmc_information.application_version.minor", 1289, 1, MB_FIELD_U8},
+    {"mmc_information.library_version.major", 1290, 1, MB_FIELD_U8},
+    {"mmc_information.library_version.minor", 1291, 1, MB_FIELD_U8},
+    {"mmc_information.cpld_board_version.major", 1292, 1, MB_FIELD_U8},
+    {"mmc_information.cpld_board_version.minor", 1293, 1, MB_FIELD_U8},
+    {"mmc_information.cpld_library_version.major", 1294, 1, MB_FIELD_U8},
+    {"mmc_information.cpld_library_version.minor", 1295, 1, MB_FIELD_U8},
+    {"mmc_information.stamp_hw_revision", 1296, 1, MB_FIELD_CHAR},
+    {"mmc_information.amc_slot_nr", 1297, 1, MB_FIELD_U8},
+    {"mmc_information.ipmb_addr", 1298, 1, MB_FIELD_U8},
+    {"mmc_information.board_name", 1299, 23, MB_FIELD_CHAR},
+    {"mmc_information.vendor_id", 1322, 2, MB_FIELD_U16},
+    {"mmc_information.product_id", 1324, 2, MB_FIELD_U16},
+    {"mmc_information.mmc_uptime", 1326, 4, MB_FIELD_U32},
+    {"mmc_information.amc_hw_revision", 1330, 1, MB_FIELD_CHAR},
+    {"mmc_information.reserved", 1331, 5, MB_FIELD_RAW},
+    {"mmc_sensor[0].name", 1336, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[0].reading", 1348, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[1].name", 1352, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[1].reading", 1364, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[2].name", 1368, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[2].reading", 1380, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[3].name", 1384, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[3].reading", 1396, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[4].name", 1400, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[4].reading", 1412, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[5].name", 1416, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[5].reading", 1428, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[6].name", 1432, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[6].reading", 1444, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[7].name", 1448, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[7].reading", 1460, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[8].name", 1464, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[8].reading", 1476, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[9].name", 1480, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[9].reading", 1492, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[10].name", 1496, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[10].reading", 1508, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[11].name", 1512, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[11].reading", 1524, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[12].name", 1528, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[12].reading", 1540, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[13].name", 1544, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[13].reading", 1556, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[14].name", 1560, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[14].reading", 1572, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[15].name", 1576, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[15].reading", 1588, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[16].name", 1592, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[16].reading", 1604, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[17].name", 1608, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[17].reading", 1620, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[18].name", 1624, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[18].reading", 1636, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[19].name", 1640, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[19].reading", 1652, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[20].name", 1656, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[20].reading", 1668, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[21].name", 1672, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[21].reading", 1684, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[22].name", 1688, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[22].reading", 1700, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[23].name", 1704, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[23].reading", 1716, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[24].name", 1720, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[24].reading", 1732, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[25].name", 1736, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[25].reading", 1748, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[26].name", 1752, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[26].reading", 1764, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[27].name", 1768, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[27].reading", 1780, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[28].name", 1784, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[28].reading", 1796, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[29].name", 1800, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[29].reading", 1812, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[30].name", 1816, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[30].reading", 1828, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[31].name", 1832, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[31].reading", 1844, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[32].name", 1848, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[32].reading", 1860, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[33].name", 1864, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[33].reading", 1876, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[34].name", 1880, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[34].reading", 1892, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[35].name", 1896, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[35].reading", 1908, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[36].name", 1912, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[36].reading", 1924, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[37].name", 1928, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[37].reading", 1940, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[38].name", 1944, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[38].reading", 1956, 4, MB_FIELD_FLOAT},
+    {"mmc_sensor[39].name", 1960, 12, MB_FIELD_CHAR},
+    {"mmc_sensor[39].reading", 1972, 4, MB_FIELD_FLOAT},
+    {"reserved", 1976, 43, MB_FIELD_RAW},
+    {"bp_eth_info.mac_addr", 2019, 6, MB_FIELD_U8},
+    {"bp_eth_info.ipv4_addr", 2025, 4, MB_FIELD_U8},
+    {"bp_eth_info.ipv6_addr", 2029, 16, MB_FIELD_U8},
+    {"fpga_ctrl", 2045, 1, MB_FIELD_BITS},
+    {"fpga_status", 2046, 1, MB_FIELD_BITS},
+};
+
+static const mb_version_desc_t versions[] = {
+    {2, fields_v2, NUM_ELEMS(fields_v2), undefined_v2, NUM_ELEMS(undefined_v2)},
+    {3, fields_v3, NUM_ELEMS(fields_v3), NULL, 0},
+};
+
+const mb_version_desc_t* mb_get_version_desc(unsigned version)
+{
+    for (size_t i = 0; i < NUM_ELEMS(versions); i++) {
+        if (versions[i].version == version) {
+            return &versions[i];
+        }
+    }
+    return NULL;
+}
+
+const mb_field_desc_t* mb_get_fields(unsigned version, size_t* num_fields)
+{
+    const mb_version_desc_t* desc = mb_get_version_desc(version);
+    *num_fields = desc ? desc->num_fields : 0;
+    return desc ? desc->fields : NULL;
+}
+
+void mb_clear_undefined(const mb_version_desc_t* desc, void* buf, size_t offs, size_t len)
+{
+    for (size_t i = 0; i < desc->num_undefined; i++) {
+        const mb_field_desc_t* fd = &desc->undefined[i];
+        const size_t start = fd->offs > offs ? fd->offs : offs;
+        const size_t end = fd->offs + fd->size < offs + len ? fd->offs + fd->size : offs + len;
+        if (start < end) {
+            memset((char*)buf + (start - offs), 0, end - start);
+        }
+    }
+}
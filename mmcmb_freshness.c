@@ -0,0 +1,147 @@
+/***************************************************************************
+ *      ____  _____________  __    __  __ _           _____ ___   _        *
+ *     / __ \/ ____/ ___/\ \/ /   |  \/  (_)__ _ _ __|_   _/ __| /_\  (R)  *
+ *    / / / / __/  \__ \  \  /    | |\/| | / _| '_/ _ \| || (__ / _ \      *
+ *   / /_/ / /___ ___/ /  / /     |_|  |_|_\__|_| \___/|_| \___/_/ \_\     *
+ *  /_____/_____//____/  /_/      T  E  C  H  N  O  L  O  G  Y   L A B     *
+ *                                                                         *
+ *          Copyright 2022 Deutsches Elektronen-Synchrotron DESY.          *
+ *                          All rights reserved.                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "mmcmb/mmcmb_freshness.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "mmcmb/fpga_mailbox_layout.h"
+
+#define NS_PER_MS 1000000ull
+#define NS_PER_SEC 1000000000ull
+
+// Measure the update rate over 10 s windows
+#define RATE_WINDOW_NS (10 * NS_PER_SEC)
+
+// FNV-1a
+#define FNV_OFFSET 0xcbf29ce484222325ull
+#define FNV_PRIME 0x100000001b3ull
+
+void mb_freshness_init(mb_freshness_t* f, unsigned stale_ms)
+{
+    memset(f, 0, sizeof(*f));
+    f->stale_ms = stale_ms ? stale_ms : MB_FRESHNESS_DEFAULT_STALE_MS;
+    f->state = MB_FRESHNESS_UNKNOWN;
+}
+
+uint64_t mb_freshness_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * NS_PER_SEC + ts.tv_nsec;
+}
+
+static void restart(mb_freshness_t* f, uint32_t mmc_uptime, uint64_t now_ns)
+{
+    f->uptime = mmc_uptime;
+    f->change_ns = now_ns;
+    f->window_start_ns = now_ns;
+    f->window_changes = 0;
+}
+
+mb_freshness_state_t mb_freshness_update(mb_freshness_t* f, uint32_t mmc_uptime, uint64_t now_ns)
+{
+    if (f->state == MB_FRESHNESS_UNKNOWN) {
+        restart(f, mmc_uptime, now_ns);
+        f->state = MB_FRESHNESS_FRESH;
+        return f->state;
+    }
+
+    if (mmc_uptime < f->uptime) {
+        f->mmc_restarts++;
+        restart(f, mmc_uptime, now_ns);
+        f->state = MB_FRESHNESS_RESTARTED;
+        return f->state;
+    }
+
+    if (mmc_uptime != f->uptime) {
+        if (f->state == MB_FRESHNESS_STALE) {
+            // Did the MMC uptime keep up with the wall clock while we saw no updates?
+            const uint64_t wall_s = (now_ns - f->change_ns) / NS_PER_SEC;
+            if (mmc_uptime - f->uptime + 1 >= wall_s) {
+                f->held_back++;
+            } else {
+                f->mmc_stalls++;
+            }
+        }
+        f->uptime = mmc_uptime;
+        f->change_ns = now_ns;
+        f->window_changes++;
+        f->state = MB_FRESHNESS_FRESH;
+    } else if (mb_freshness_age_ms(f, now_ns) > f->stale_ms && f->state != MB_FRESHNESS_STALE) {
+        f->stale_events++;
+        f->state = MB_FRESHNESS_STALE;
+    } else if (f->state == MB_FRESHNESS_RESTARTED) {
+        f->state = MB_FRESHNESS_FRESH;
+    }
+
+    if (now_ns - f->window_start_ns >= RATE_WINDOW_NS) {
+        f->update_rate_hz = (double)f->window_changes * NS_PER_SEC / (now_ns - f->window_start_ns);
+        f->window_start_ns = now_ns;
+        f->window_changes = 0;
+    }
+    return f->state;
+}
+
+void mb_freshness_update_sensors(mb_freshness_t* f,
+                                 const mb_mmc_sensor_t* sen,
+                                 size_t n,
+                                 uint64_t now_ns)
+{
+    uint64_t hash = FNV_OFFSET;
+    const uint8_t* p = (const uint8_t*)sen;
+    for (size_t i = 0; i < n * sizeof(*sen); i++) {
+        hash = (hash ^ p[i]) * FNV_PRIME;
+    }
+    if (hash != f->sensor_hash || !f->sensor_change_ns) {
+        f->sensor_hash = hash;
+        f->sensor_change_ns = now_ns;
+    }
+}
+
+mb_freshness_state_t mb_freshness_update_snapshot(mb_freshness_t* f,
+                                                  const mb_memory_contents_t* snap,
+                                                  uint64_t now_ns)
+{
+    mb_freshness_update_sensors(f, snap->mmc_sensor, MAX_SENS_MMC, now_ns);
+    return mb_freshness_update(f, snap->mmc_information.mmc_uptime, now_ns);
+}
+
+uint64_t mb_freshness_age_ms(const mb_freshness_t* f, uint64_t now_ns)
+{
+    return f->change_ns ? (now_ns - f->change_ns) / NS_PER_MS : 0;
+}
+
+uint64_t mb_freshness_sensor_age_ms(const mb_freshness_t* f, uint64_t now_ns)
+{
+    return f->sensor_change_ns ? (now_ns - f->sensor_change_ns) / NS_PER_MS : 0;
+}
+
+const char* mb_freshness_state_str(mb_freshness_state_t state)
+{
+    switch (state) {
+        case MB_FRESHNESS_UNKNOWN:
+            return "unknown";
+        case MB_FRESHNESS_FRESH:
+            return "fresh";
+        case MB_FRESHNESS_STALE:
+            return "stale";
+        case MB_FRESHNESS_RESTARTED:
+            return "restarted";
+        default:
+            return "invalid";
+    }
+}
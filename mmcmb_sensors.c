@@ -0,0 +1,242 @@
+/***************************************************************************
+ *      ____  _____________  __    __  __ _           _____ ___   _        *
+ *     / __ \/ ____/ ___/\ \/ /   |  \/  (_)__ _ _ __|_   _/ __| /_\  (R)  *
+ *    / / / / __/  \__ \  \  /    | |\/| | / _| '_/ _ \| || (__ / _ \      *
+ *   / /_/ / /___ ___/ /  / /     |_|  |_|_\__|_| \___/|_| \___/_/ \_\     *
+ *  /_____/_____//____/  /_/      T  E  C  H  N  O  L  O  G  Y   L A B     *
+ *                                                                         *
+ *          Copyright 2022 Deutsches Elektronen-Synchrotron DESY.          *
+ *                          All rights reserved.                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "mmcmb/mmcmb_sensors.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "mmcmb/fpga_mailbox_layout.h"
+#include "mmcmb/mmcmb.h"
+
+#define BUCKET_MASK (MB_SENSOR_INDEX_BUCKETS - 1)
+
+// Don't rebuild the library's index on lookup misses more often than the MMC updates
+#define INDEX_MISS_REBUILD_NS 1000000000ull
+
+// Read up to READ_GAP unneeded slots between two needed ones rather than starting
+// another I2C transaction (address & offset setup) for the next slot
+#define READ_GAP 1
+
+// FNV-1a
+#define FNV_OFFSET 0x811c9dc5u
+#define FNV_PRIME 0x01000193u
+
+static_assert(MB_SENSOR_INDEX_BUCKETS > MAX_SENS_MMC, "Sensor index too small");
+static_assert((MB_SENSOR_INDEX_BUCKETS & BUCKET_MASK) == 0, "Bucket count not a power of two");
+static_assert(MAX_SENS_MMC <= 64, "Slot set does not fit into uint64_t");
+
+static uint32_t name_hash(const char* name, size_t len)
+{
+    uint32_t hash = FNV_OFFSET;
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ (uint8_t)name[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+void mb_sensor_index_build(mb_sensor_index_t* idx, const mb_mmc_sensor_t* sen)
+{
+    memset(idx->bucket, -1, sizeof(idx->bucket));
+
+    for (size_t slot = 0; slot < MAX_SENS_MMC; slot++) {
+        char* name = idx->names[slot];
+        memcpy(name, sen[slot].name, MB_SENSOR_NAME_LEN);
+        if (!name[0]) {
+            continue;
+        }
+
+        uint32_t b = name_hash(name, strnlen(name, MB_SENSOR_NAME_LEN)) & BUCKET_MASK;
+        while (idx->bucket[b] >= 0) {
+            if (!strncmp(idx->names[idx->bucket[b]], name, MB_SENSOR_NAME_LEN)) {
+                break;  // Duplicate name
+            }
+            b = (b + 1) & BUCKET_MASK;
+        }
+        if (idx->bucket[b] < 0) {
+            idx->bucket[b] = slot;
+        }
+    }
+}
+
+bool mb_sensor_index_update(mb_sensor_index_t* idx, const mb_mmc_sensor_t* sen)
+{
+    for (size_t slot = 0; slot < MAX_SENS_MMC; slot++) {
+        if (memcmp(idx->names[slot], sen[slot].name, MB_SENSOR_NAME_LEN)) {
+            mb_sensor_index_build(idx, sen);
+            return true;
+        }
+    }
+    return false;
+}
+
+int mb_sensor_index_find(const mb_sensor_index_t* idx, const char* name)
+{
+    const size_t len = strnlen(name, MB_SENSOR_NAME_LEN + 1);
+    if (len == 0 || len > MB_SENSOR_NAME_LEN) {
+        return -1;
+    }
+
+    uint32_t b = name_hash(name, len) & BUCKET_MASK;
+    while (idx->bucket[b] >= 0) {
+        const int slot = idx->bucket[b];
+        if (!strncmp(idx->names[slot], name, MB_SENSOR_NAME_LEN)) {
+            return slot;
+        }
+        b = (b + 1) & BUCKET_MASK;
+    }
+    return -1;
+}
+
+/* Live mailbox access */
+
+static mb_sensor_index_t lib_index;
+static bool lib_index_valid = false;
+static uint64_t lib_index_ns = 0;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// Read all sensors into <sen> and rebuild the index from them
+static bool rebuild_lib_index(mb_mmc_sensor_t* sen)
+{
+    if (!mb_get_mmc_sensors(sen, 0, MAX_SENS_MMC)) {
+        return false;
+    }
+    mb_sensor_index_build(&lib_index, sen);
+    lib_index_valid = true;
+    lib_index_ns = now_ns();
+    return true;
+}
+
+static bool miss_rebuild_allowed(void)
+{
+    return now_ns() - lib_index_ns >= INDEX_MISS_REBUILD_NS;
+}
+
+// Read the slots in <wanted> into the corresponding entries of <sen>
+static bool read_slots(mb_mmc_sensor_t* sen, uint64_t wanted)
+{
+    size_t slot = 0;
+    while (slot < MAX_SENS_MMC) {
+        if (!(wanted & (1ull << slot))) {
+            slot++;
+            continue;
+        }
+        const size_t first = slot;
+        size_t last = slot;
+        for (slot++; slot < MAX_SENS_MMC && slot - last <= READ_GAP + 1; slot++) {
+            if (wanted & (1ull << slot)) {
+                last = slot;
+            }
+        }
+        if (!mb_get_mmc_sensors(&sen[first], first, last - first + 1)) {
+            return false;
+        }
+        slot = last + 1;
+    }
+    return true;
+}
+
+int mb_find_sensor(const char* name)
+{
+    mb_mmc_sensor_t sen[MAX_SENS_MMC];
+    if (!lib_index_valid && !rebuild_lib_index(sen)) {
+        return -1;
+    }
+
+    int slot = mb_sensor_index_find(&lib_index, name);
+    if (slot < 0 && miss_rebuild_allowed() && rebuild_lib_index(sen)) {
+        slot = mb_sensor_index_find(&lib_index, name);
+    }
+    return slot;
+}
+
+bool mb_get_mmc_sensors_by_name(mb_mmc_sensor_t* sen, const char* const* names, size_t n)
+{
+    mb_mmc_sensor_t buf[MAX_SENS_MMC];
+    bool full = false;  // <buf> holds all sensors the index was built from
+
+    if (!lib_index_valid) {
+        if (!rebuild_lib_index(buf)) {
+            return false;
+        }
+        full = true;
+    }
+
+    for (;;) {
+        uint64_t wanted = 0;
+        bool miss = false;
+        for (size_t i = 0; i < n; i++) {
+            const int slot = mb_sensor_index_find(&lib_index, names[i]);
+            if (slot < 0) {
+                miss = true;
+            } else {
+                wanted |= 1ull << slot;
+            }
+        }
+        if (full) {
+            break;
+        }
+        if (miss && miss_rebuild_allowed()) {
+            if (!rebuild_lib_index(buf)) {
+                return false;
+            }
+            full = true;
+            continue;
+        }
+        if (!read_slots(buf, wanted)) {
+            return false;
+        }
+
+        // The name table changed since the index was built?
+        bool mismatch = false;
+        for (size_t slot = 0; slot < MAX_SENS_MMC; slot++) {
+            if ((wanted & (1ull << slot))
+                && strncmp(buf[slot].name, lib_index.names[slot], MB_SENSOR_NAME_LEN)) {
+                mismatch = true;
+            }
+        }
+        if (!mismatch) {
+            break;
+        }
+        if (!rebuild_lib_index(buf)) {
+            return false;
+        }
+        full = true;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        const int slot = mb_sensor_index_find(&lib_index, names[i]);
+        if (slot >= 0) {
+            sen[i] = buf[slot];
+        } else {
+            memset(sen[i].name, 0, sizeof(sen[i].name));
+            sen[i].reading = NAN;
+        }
+    }
+    return true;
+}
+
+void mb_sensor_index_invalidate(void)
+{
+    lib_index_valid = false;
+}
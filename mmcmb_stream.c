@@ -0,0 +1,125 @@
+/***************************************************************************
+ *      ____  _____________  __    __  __ _           _____ ___   _        *
+ *     / __ \/ ____/ ___/\ \/ /   |  \/  (_)__ _ _ __|_   _/ __| /_\  (R)  *
+ *    / / / / __/  \__ \  \  /    | |\/| | / _| '_/ _ \| || (__ / _ \      *
+ *   / /_/ / /___ ___/ /  / /     |_|  |_|_\__|_| \___/|_| \___/_/ \_\     *
+ *  /_____/_____//____/  /_/      T  E  C  H  N  O  L  O  G  Y   L A B     *
+ *                                                                         *
+ *          Copyright 2022 Deutsches Elektronen-Synchrotron DESY.          *
+ *                          All rights reserved.                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "mmcmb/mmcmb_stream.h"
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "mmcmb/fpga_mailbox_layout.h"
+#include "mmcmb/mmcmb_archive.h"
+
+#define SNAPSHOT_SIZE sizeof(mb_memory_contents_t)
+
+bool mb_stream_send(int fd, const mb_stream_hdr_t* hdr, const void* payload)
+{
+    struct iovec iov[2] = {
+        {(void*)hdr, sizeof(*hdr)},
+        {(void*)payload, hdr->payload_len},
+    };
+    const struct msghdr msg = {
+        .msg_iov = iov,
+        .msg_iovlen = hdr->payload_len ? 2 : 1,
+    };
+    const ssize_t len = sizeof(*hdr) + hdr->payload_len;
+    ssize_t n;
+    do {
+        n = sendmsg(fd, &msg, MSG_DONTWAIT | MSG_NOSIGNAL);
+    } while (n < 0 && errno == EINTR);
+    return n == len;
+}
+
+bool mb_stream_send_snapshot(int fd,
+                             uint64_t timestamp_ns,
+                             const mb_memory_contents_t* prev,
+                             const mb_memory_contents_t* cur)
+{
+    mb_stream_hdr_t hdr = {
+        .magic = MB_STREAM_MAGIC,
+        .type = MB_STREAM_DELTA,
+        .amc_slot_nr = cur->mmc_information.amc_slot_nr,
+        .ipmb_addr = cur->mmc_information.ipmb_addr,
+        .timestamp_ns = timestamp_ns,
+    };
+    uint8_t delta[SNAPSHOT_SIZE];
+    const void* payload = delta;
+
+    if (prev) {
+        if (!memcmp(prev, cur, SNAPSHOT_SIZE)) {
+            return true;
+        }
+        hdr.payload_len = mb_delta_encode(prev, cur, SNAPSHOT_SIZE, delta, sizeof(delta));
+    }
+    if (hdr.payload_len == 0) {
+        // No previous snapshot, or the delta would be larger than a keyframe
+        hdr.type = MB_STREAM_KEYFRAME;
+        hdr.payload_len = SNAPSHOT_SIZE;
+        payload = cur;
+    }
+    return mb_stream_send(fd, &hdr, payload);
+}
+
+void mb_stream_rx_init(mb_stream_rx_t* rx)
+{
+    rx->fill = 0;
+}
+
+int mb_stream_recv(mb_stream_rx_t* rx, int fd)
+{
+    for (;;) {
+        size_t want = sizeof(rx->hdr);
+        if (rx->fill >= sizeof(rx->hdr)) {
+            if (rx->hdr.magic != MB_STREAM_MAGIC
+                || rx->hdr.payload_len > MB_STREAM_MAX_PAYLOAD) {
+                return -1;
+            }
+            want += rx->hdr.payload_len;
+        }
+        if (rx->fill == want) {
+            return 1;
+        }
+
+        const ssize_t n = read(fd, &rx->buf[rx->fill], want - rx->fill);
+        if (n > 0) {
+            rx->fill += n;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return 0;
+        } else {
+            return -1;
+        }
+    }
+}
+
+bool mb_stream_apply(const mb_stream_rx_t* rx, mb_memory_contents_t* snap)
+{
+    switch (rx->hdr.type) {
+        case MB_STREAM_KEYFRAME:
+            if (rx->hdr.payload_len != SNAPSHOT_SIZE) {
+                return false;
+            }
+            memcpy(snap, mb_stream_payload(rx), SNAPSHOT_SIZE);
+            return true;
+        case MB_STREAM_DELTA:
+            return mb_delta_apply(snap, SNAPSHOT_SIZE, mb_stream_payload(rx), rx->hdr.payload_len);
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,116 @@
+/***************************************************************************
+ *      ____  _____________  __    __  __ _           _____ ___   _        *
+ *     / __ \/ ____/ ___/\ \/ /   |  \/  (_)__ _ _ __|_   _/ __| /_\  (R)  *
+ *    / / / / __/  \__ \  \  /    | |\/| | / _| '_/ _ \| || (__ / _ \      *
+ *   / /_/ / /___ ___/ /  / /     |_|  |_|_\__|_| \___/|_| \___/_/ \_\     *
+ *  /_____/_____//____/  /_/      T  E  C  H  N  O  L  O  G  Y   L A B     *
+ *                                                                         *
+ *          Copyright 2022 Deutsches Elektronen-Synchrotron DESY.          *
+ *                          All rights reserved.                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "mmcmb/mmcmb_validate.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "mmcmb/fpga_mailbox_layout.h"
+
+static_assert(MB_VALID_FRU_STR(NUM_FRUS, 0) <= MB_VALID_MMC_SENSOR_0, "Validity bits overlap");
+static_assert(MAX_SENS_PER_FRU <= 8, "FRU temperature mask too small");
+static_assert(MB_VALID_WORDS == 2, "Validity bitmap size mismatch");
+
+// Every field is looked at once, and its bits are set as it is checked. The string checks
+// are branch-free loops over the (short) fixed-size fields.
+
+// String byte check: printable ASCII, or zero padding after the string
+static inline uint8_t str_byte_bad(uint8_t c, uint8_t prev)
+{
+    return (c != 0) & (((uint8_t)(c - 0x20) > 0x5e) | (prev == 0));
+}
+
+static bool str_ok(const char* str, size_t len)
+{
+    const uint8_t* s = (const uint8_t*)str;
+    uint8_t bad = str_byte_bad(s[0], 1);
+    for (size_t i = 1; i < len; i++) {
+        bad |= str_byte_bad(s[i], s[i - 1]);
+    }
+    return !bad;
+}
+
+#define STR_OK(field) str_ok((field), sizeof(field))
+
+static bool fru_status_ok(const mb_fru_status_t* stat, size_t fru_id)
+{
+    bool ok = !stat->status_reserved && stat->num_temp_sensors <= MAX_SENS_PER_FRU;
+    if (fru_id == 2 || fru_id == 3) {
+        ok &= !stat->ext.fmc.reserved_1 && !stat->ext.fmc.reserved_2;
+    } else {
+        ok &= !stat->ext.bytes_reserved[0] && !stat->ext.bytes_reserved[1];
+    }
+    return ok;
+}
+
+// Mask of the usable temperature sensors
+static unsigned fru_temp_mask(const mb_fru_status_t* stat)
+{
+    const unsigned n = stat->num_temp_sensors;
+    unsigned mask = 0;
+    for (unsigned i = 0; i < MAX_SENS_PER_FRU; i++) {
+        mask |= (unsigned)((i < n) & (stat->temperature[i] != FRU_TEMP_INVALID)) << i;
+    }
+    return mask;
+}
+
+// Mask of the FRU description strings which are well-formed
+static unsigned fru_str_mask(const mb_fru_description_t* desc)
+{
+    return (unsigned)STR_OK(desc->manufacturer) << MB_FRU_MANUFACTURER
+           | (unsigned)STR_OK(desc->product) << MB_FRU_PRODUCT
+           | (unsigned)STR_OK(desc->part_nr) << MB_FRU_PART_NR
+           | (unsigned)STR_OK(desc->serial_nr) << MB_FRU_SERIAL_NR
+           | (unsigned)STR_OK(desc->version) << MB_FRU_VERSION;
+}
+
+// Mask of the sensors which are named (well-formed) and have a reading
+static uint64_t sensor_mask(const mb_memory_contents_t* mb)
+{
+    uint64_t mask = 0;
+    for (size_t i = 0; i < MAX_SENS_MMC; i++) {
+        const mb_mmc_sensor_t* sen = &mb->mmc_sensor[i];
+        const bool ok = sen->name[0] != 0 && !isnan(sen->reading) && STR_OK(sen->name);
+        mask |= (uint64_t)ok << i;
+    }
+    return mask;
+}
+
+void mb_validate_snapshot(const mb_memory_contents_t* mb, mb_validity_t* v)
+{
+    uint64_t w0 = 0;
+
+    w0 |= (uint64_t)!memcmp(mb->mailbox_magic_str, MB_MAGIC_STR, sizeof(mb->mailbox_magic_str))
+          << MB_VALID_MAGIC;
+    w0 |= (uint64_t)(mb->mailbox_version >= MB_VERSION_MIN
+                     && mb->mailbox_version <= MB_VERSION_MAX)
+          << MB_VALID_VERSION;
+
+    for (size_t f = 0; f < NUM_FRUS; f++) {
+        const mb_fru_information_t* fru = &mb->fru_information[f];
+        w0 |= (uint64_t)fru_status_ok(&fru->status, f) << MB_VALID_FRU_STATUS(f);
+        w0 |= (uint64_t)fru_temp_mask(&fru->status) << MB_VALID_FRU_TEMP(f, 0);
+        w0 |= (uint64_t)fru_str_mask(&fru->description) << MB_VALID_FRU_STR(f, 0);
+    }
+
+    w0 |= (uint64_t)STR_OK(mb->mmc_information.board_name) << MB_VALID_BOARD_NAME;
+
+    w0 |= (uint64_t)!mb->fpga_ctrl.reserved << MB_VALID_FPGA_CTRL;
+    w0 |= (uint64_t)!mb->fpga_status.reserved << MB_VALID_FPGA_STATUS;
+
+    v->bits[0] = w0;
+    v->bits[1] = sensor_mask(mb) << (MB_VALID_MMC_SENSOR_0 - 64);
+}
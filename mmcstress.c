@@ -0,0 +1,593 @@
+/***************************************************************************
+ *      ____  _____________  __    __  __ _           _____ ___   _        *
+ *     / __ \/ ____/ ___/\ \/ /   |  \/  (_)__ _ _ __|_   _/ __| /_\  (R)  *
+ *    / / / / __/  \__ \  \  /    | |\/| | / _| '_/ _ \| || (__ / _ \      *
+ *   / /_/ / /___ ___/ /  / /     |_|  |_|_\__|_| \___/|_| \___/_/ \_\     *
+ *  /_____/_____//____/  /_/      T  E  C  H  N  O  L  O  G  Y   L A B     *
+ *                                                                         *
+ *          Copyright 2022 Deutsches Elektronen-Synchrotron DESY.          *
+ *                          All rights reserved.                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "mmcmb/fpga_mailbox_layout.h"
+#include "mmcmb/mmcmb.h"
+#include "mmcmb/mmcmb_freshness.h"
+
+/* Mailbox contention stress test
+ *
+ * Runs N clients (threads with their own file descriptors, like separate processes)
+ * reading the mailbox with a given access pattern, and reports the throughput, the
+ * client latencies, the I2C bus utilisation and the effect on the MMC updates.
+ *
+ * Simulated backend: models the I2C bus (one transaction at a time, byte timing of the
+ * configured bus clock) and the mailbox page lock, which is held during multi-byte
+ * transfers. An MMC thread swaps the pages once per second and counts the swaps that
+ * were blocked by the lock.
+ *
+ * Real backend: uses the mailbox EEPROM device. The bus time is estimated from the
+ * transferred bytes, the MMC updates are observed via mmc_uptime.
+ */
+
+#define DEFAULT_CLIENTS 4
+#define DEFAULT_DURATION_S 10
+#define DEFAULT_BUS_HZ 400000
+
+#define NS_PER_US 1000ull
+#define NS_PER_MS 1000000ull
+#define NS_PER_SEC 1000000000ull
+
+// I2C framing: address + 16-bit offset (+ repeated start & address for reads),
+// 9 bit times per byte incl. ACK
+#define I2C_READ_OVERHEAD 4
+#define I2C_WRITE_OVERHEAD 3
+#define I2C_BITS_PER_BYTE 9
+
+// MMC: update once per second, retry the page swap every millisecond while locked
+#define MMC_UPDATE_NS NS_PER_SEC
+#define MMC_RETRY_NS NS_PER_MS
+
+// Observe mmc_uptime (real backend) 10 times per second
+#define OBSERVE_INTERVAL_NS (100 * NS_PER_MS)
+
+// Mixed pattern: per mille of snapshot reads & writes, the rest are field reads
+#define MIXED_SNAPSHOT_PERMILLE 50
+#define MIXED_WRITE_PERMILLE 50
+
+typedef enum pattern {
+    PATTERN_FIELD,
+    PATTERN_SNAPSHOT,
+    PATTERN_MIXED,
+} pattern_t;
+
+typedef struct client {
+    pthread_t thread;
+    int fd;  // Real backend
+    unsigned seed;
+
+    // Results
+    bool error;
+    unsigned long ops;
+    uint64_t bytes_read;
+    uint64_t bytes_written;
+    uint64_t bus_ns;  // Nominal bus time of the transfers
+    uint64_t* lat_ns;
+    size_t lat_len, lat_cap;
+} client_t;
+
+static struct {
+    bool simulate;
+    pattern_t pattern;
+    unsigned bus_hz;
+    uint64_t interval_ns;  // Client think time between operations
+    uint64_t end_ns;
+    const mb_field_desc_t* fields;
+    size_t num_fields;
+} cfg;
+
+// Simulated mailbox
+static struct {
+    pthread_mutex_t bus;
+    pthread_mutex_t pages_lock;
+    bool locked;  // Page lock, held during multi-byte transfers
+    mb_memory_contents_t page[2];
+    unsigned active;
+    uint64_t busy_ns;
+
+    unsigned long swaps;
+    unsigned long swaps_missed;    // Updates skipped because the lock was held too long
+    unsigned long swaps_blocked;   // Swap attempts blocked by the lock
+    uint64_t swap_delay_max_ns;
+} sim = {
+    .bus = PTHREAD_MUTEX_INITIALIZER,
+    .pages_lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static atomic_bool stop = false;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * NS_PER_SEC + ts.tv_nsec;
+}
+
+static void sleep_until(uint64_t t_ns)
+{
+    const struct timespec ts = {
+        .tv_sec = t_ns / NS_PER_SEC,
+        .tv_nsec = t_ns % NS_PER_SEC,
+    };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+}
+
+static uint64_t i2c_time_ns(size_t n, bool write)
+{
+    const size_t bytes = n + (write ? I2C_WRITE_OVERHEAD : I2C_READ_OVERHEAD);
+    return bytes * I2C_BITS_PER_BYTE * NS_PER_SEC / cfg.bus_hz;
+}
+
+/* Simulated backend */
+
+static void sim_transfer(size_t offs, void* buf, size_t n, bool write)
+{
+    pthread_mutex_lock(&sim.bus);
+    const uint64_t start = now_ns();
+
+    pthread_mutex_lock(&sim.pages_lock);
+    sim.locked = n > 1;
+    pthread_mutex_unlock(&sim.pages_lock);
+
+    sleep_until(start + i2c_time_ns(n, write));
+
+    pthread_mutex_lock(&sim.pages_lock);
+    uint8_t* page = (uint8_t*)&sim.page[sim.active];
+    if (write) {
+        memcpy(&page[offs], buf, n);
+    } else {
+        memcpy(buf, &page[offs], n);
+    }
+    sim.locked = false;
+    pthread_mutex_unlock(&sim.pages_lock);
+
+    sim.busy_ns += now_ns() - start;
+    pthread_mutex_unlock(&sim.bus);
+}
+
+static void* sim_mmc_thread(void* arg)
+{
+    (void)arg;
+    uint64_t next = now_ns() + MMC_UPDATE_NS;
+    uint32_t uptime = sim.page[0].mmc_information.mmc_uptime;
+
+    while (!atomic_load(&stop)) {
+        sleep_until(next);
+        uptime++;
+
+        // Try to swap pages until it succeeds, or the next update is due
+        const uint64_t due = next;
+        next += MMC_UPDATE_NS;
+        bool swapped = false;
+        for (uint64_t t = due; !swapped && t < next && !atomic_load(&stop); t += MMC_RETRY_NS) {
+            pthread_mutex_lock(&sim.pages_lock);
+            if (!sim.locked) {
+                const unsigned inactive = !sim.active;
+                sim.page[inactive] = sim.page[sim.active];
+                sim.page[inactive].mmc_information.mmc_uptime = uptime;
+                sim.active = inactive;
+                sim.swaps++;
+                const uint64_t delay = now_ns() - due;
+                if (delay > sim.swap_delay_max_ns) {
+                    sim.swap_delay_max_ns = delay;
+                }
+                swapped = true;
+            } else {
+                sim.swaps_blocked++;
+            }
+            pthread_mutex_unlock(&sim.pages_lock);
+            if (!swapped) {
+                sleep_until(t + MMC_RETRY_NS);
+            }
+        }
+        if (!swapped && !atomic_load(&stop)) {
+            sim.swaps_missed++;
+        }
+    }
+    return NULL;
+}
+
+static bool sim_init(const char* image)
+{
+    mb_memory_contents_t* mb = &sim.page[0];
+    if (image) {
+        FILE* f = fopen(image, "rb");
+        const bool ok = f && fread(mb, sizeof(*mb), 1, f) == 1;
+        if (f) {
+            fclose(f);
+        }
+        if (!ok) {
+            fprintf(stderr, "Could not read mailbox image %s\n", image);
+            return false;
+        }
+    } else {
+        memcpy(mb->mailbox_magic_str, MB_MAGIC_STR, sizeof(mb->mailbox_magic_str));
+        mb->mailbox_version = MB_LAYOUT_VERSION;
+    }
+    sim.page[1] = sim.page[0];
+    return true;
+}
+
+/* Client operations */
+
+static bool transfer(client_t* c, size_t offs, void* buf, size_t n, bool write)
+{
+    c->bus_ns += i2c_time_ns(n, write);
+    if (cfg.simulate) {
+        sim_transfer(offs, buf, n, write);
+        return true;
+    }
+    const ssize_t ret = write ? pwrite(c->fd, buf, n, offs) : pread(c->fd, buf, n, offs);
+    return ret == (ssize_t)n;
+}
+
+static bool client_op(client_t* c)
+{
+    uint8_t buf[sizeof(mb_memory_contents_t)];
+    const unsigned r = rand_r(&c->seed);
+
+    bool snapshot = cfg.pattern == PATTERN_SNAPSHOT;
+    bool write = false;
+    if (cfg.pattern == PATTERN_MIXED) {
+        const unsigned permille = r % 1000;
+        snapshot = permille < MIXED_SNAPSHOT_PERMILLE;
+        write = !snapshot && permille < MIXED_SNAPSHOT_PERMILLE + MIXED_WRITE_PERMILLE;
+    }
+
+    if (write) {
+        // Write back the NIC information read just before, so updates by mmcctrld are only
+        // lost if they fall between the two transfers
+        const size_t n = sizeof(mb_nic_information_t);
+        c->bytes_read += n;
+        c->bytes_written += n;
+        return transfer(c, MB_EEPROM_OFFS(bp_eth_info), buf, n, false)
+               && transfer(c, MB_EEPROM_OFFS(bp_eth_info), buf, n, true);
+    }
+    if (snapshot) {
+        c->bytes_read += sizeof(buf);
+        return transfer(c, 0, buf, sizeof(buf), false);
+    }
+    const mb_field_desc_t* fd = &cfg.fields[(r / 1000) % cfg.num_fields];
+    c->bytes_read += fd->size;
+    return transfer(c, fd->offs, buf, fd->size, false);
+}
+
+static bool record_latency(client_t* c, uint64_t lat_ns)
+{
+    if (c->lat_len == c->lat_cap) {
+        const size_t cap = c->lat_cap ? 2 * c->lat_cap : 1024;
+        uint64_t* lat = realloc(c->lat_ns, cap * sizeof(*lat));
+        if (!lat) {
+            return false;
+        }
+        c->lat_ns = lat;
+        c->lat_cap = cap;
+    }
+    c->lat_ns[c->lat_len++] = lat_ns;
+    return true;
+}
+
+static void* client_thread(void* arg)
+{
+    client_t* c = arg;
+    uint64_t next = now_ns();
+
+    while (!atomic_load(&stop) && next < cfg.end_ns) {
+        const uint64_t start = now_ns();
+        if (!client_op(c) || !record_latency(c, now_ns() - start)) {
+            c->error = true;
+            break;
+        }
+        c->ops++;
+        if (cfg.interval_ns) {
+            next += cfg.interval_ns;
+            sleep_until(next);
+        } else {
+            next = now_ns();
+        }
+    }
+    return NULL;
+}
+
+/* Real backend: observe the MMC updates */
+
+typedef struct observer {
+    int fd;
+    mb_freshness_t fresh;
+    unsigned long updates;
+} observer_t;
+
+static void* observer_thread(void* arg)
+{
+    observer_t* o = arg;
+    uint32_t last = 0;
+    bool have_last = false;
+
+    for (uint64_t t = now_ns(); !atomic_load(&stop) && t < cfg.end_ns; t += OBSERVE_INTERVAL_NS) {
+        uint32_t uptime;
+        const size_t offs = MB_EEPROM_OFFS(mmc_information.mmc_uptime);
+        if (pread(o->fd, &uptime, sizeof(uptime), offs) == sizeof(uptime)) {
+            mb_freshness_update(&o->fresh, uptime, now_ns());
+            o->updates += have_last && uptime != last;
+            last = uptime;
+            have_last = true;
+        }
+        sleep_until(t + OBSERVE_INTERVAL_NS);
+    }
+    return NULL;
+}
+
+/* Report */
+
+static int cmp_u64(const void* a, const void* b)
+{
+    const uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+static double percentile_us(const uint64_t* lat, size_t n, double p)
+{
+    if (!n) {
+        return 0;
+    }
+    size_t i = p * n;
+    return (double)lat[i < n ? i : n - 1] / NS_PER_US;
+}
+
+static void print_latencies(const char* name, uint64_t* lat, size_t n)
+{
+    qsort(lat, n, sizeof(*lat), cmp_u64);
+    printf("  %-10s: %9.0f %9.0f %9.0f %9.0f\n",
+           name,
+           percentile_us(lat, n, 0.5),
+           percentile_us(lat, n, 0.99),
+           percentile_us(lat, n, 0.999),
+           n ? (double)lat[n - 1] / NS_PER_US : 0);
+}
+
+static const char* pattern_str[] = {"field", "snapshot", "mixed"};
+
+static void report(client_t* clients, unsigned n, double duration_s, const observer_t* obs)
+{
+    unsigned long ops = 0;
+    uint64_t bytes_read = 0, bytes_written = 0;
+    size_t lat_total = 0;
+    for (unsigned i = 0; i < n; i++) {
+        ops += clients[i].ops;
+        bytes_read += clients[i].bytes_read;
+        bytes_written += clients[i].bytes_written;
+        lat_total += clients[i].lat_len;
+    }
+
+    // Bus time: measured (simulated bus) or estimated from the transfers (real device)
+    uint64_t bus_ns = sim.busy_ns;
+    if (!cfg.simulate) {
+        for (unsigned i = 0; i < n; i++) {
+            bus_ns += clients[i].bus_ns;
+        }
+    }
+    const double bus_s = (double)bus_ns / NS_PER_SEC;
+
+    printf("%-12s: %s, %u kHz bus\n",
+           "Backend",
+           cfg.simulate ? "simulated" : mb_get_eeprom_path(),
+           cfg.bus_hz / 1000);
+    printf("%-12s: %u x %s, %.1f s\n", "Clients", n, pattern_str[cfg.pattern], duration_s);
+    printf("%-12s: %lu (%.1f/s), %.1f kB read, %.1f kB written\n",
+           "Operations",
+           ops,
+           ops / duration_s,
+           bytes_read / 1e3,
+           bytes_written / 1e3);
+    printf("%-12s: %.1f %%%s\n",
+           "Bus busy",
+           100 * bus_s / duration_s,
+           cfg.simulate ? "" : " (estimated)");
+
+    printf("%-12s: %9s %9s %9s %9s\n", "Latency (us)", "p50", "p99", "p99.9", "max");
+    uint64_t* all = malloc((lat_total ? lat_total : 1) * sizeof(*all));
+    size_t all_len = 0;
+    for (unsigned i = 0; i < n; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "client %u", i);
+        print_latencies(name, clients[i].lat_ns, clients[i].lat_len);
+        if (all) {
+            memcpy(&all[all_len], clients[i].lat_ns, clients[i].lat_len * sizeof(*all));
+            all_len += clients[i].lat_len;
+        }
+    }
+    if (all) {
+        print_latencies("all", all, all_len);
+        free(all);
+    }
+
+    const unsigned long expected = duration_s * NS_PER_SEC / MMC_UPDATE_NS;
+    if (cfg.simulate) {
+        printf("%-12s: %lu expected, %lu done, %lu missed, max. delay %.1f ms, "
+               "%lu swap attempts blocked\n",
+               "MMC updates",
+               expected,
+               sim.swaps,
+               sim.swaps_missed,
+               (double)sim.swap_delay_max_ns / NS_PER_MS,
+               sim.swaps_blocked);
+    } else if (obs) {
+        printf("%-12s: %lu expected, %lu observed, %u stale periods\n",
+               "MMC updates",
+               expected,
+               obs->updates,
+               obs->fresh.stale_events);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    unsigned n_clients = DEFAULT_CLIENTS;
+    unsigned duration_s = DEFAULT_DURATION_S;
+    const char* image = NULL;
+
+    cfg.pattern = PATTERN_FIELD;
+    cfg.bus_hz = DEFAULT_BUS_HZ;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:t:p:i:sr:b:")) != -1) {
+        switch (opt) {
+            case 'n':
+                n_clients = strtoul(optarg, NULL, 0);
+                break;
+            case 't':
+                duration_s = strtoul(optarg, NULL, 0);
+                break;
+            case 'p':
+                if (!strcmp(optarg, "field")) {
+                    cfg.pattern = PATTERN_FIELD;
+                } else if (!strcmp(optarg, "snapshot")) {
+                    cfg.pattern = PATTERN_SNAPSHOT;
+                } else if (!strcmp(optarg, "mixed")) {
+                    cfg.pattern = PATTERN_MIXED;
+                } else {
+                    goto usage;
+                }
+                break;
+            case 'i':
+                cfg.interval_ns = strtoul(optarg, NULL, 0) * NS_PER_MS;
+                break;
+            case 's':
+                cfg.simulate = true;
+                break;
+            case 'r':
+                image = optarg;
+                break;
+            case 'b':
+                cfg.bus_hz = strtoul(optarg, NULL, 0);
+                break;
+            default:
+                goto usage;
+        }
+    }
+    if (optind != argc || n_clients < 1 || duration_s < 1 || cfg.bus_hz < 1000
+        || (image && !cfg.simulate)) {
+        goto usage;
+    }
+
+    unsigned version;
+    const char* path = NULL;
+    if (cfg.simulate) {
+        if (!sim_init(image)) {
+            return 1;
+        }
+        version = sim.page[0].mailbox_version;
+    } else {
+        path = mb_get_eeprom_path();
+        version = mb_get_version();
+        if (!path || !version || !mb_check_magic()) {
+            fprintf(stderr, "Mailbox not available\n");
+            return 1;
+        }
+    }
+    cfg.fields = mb_get_fields(version, &cfg.num_fields);
+    if (!cfg.fields) {
+        fprintf(stderr, "Unsupported mailbox version %u\n", version);
+        return 1;
+    }
+
+    client_t* clients = calloc(n_clients, sizeof(*clients));
+    if (!clients) {
+        perror("calloc");
+        return 1;
+    }
+    const int mode = cfg.pattern == PATTERN_MIXED ? O_RDWR : O_RDONLY;
+    for (unsigned i = 0; i < n_clients; i++) {
+        clients[i].fd = -1;
+        clients[i].seed = i + 1;
+        if (!cfg.simulate && (clients[i].fd = open(path, mode)) < 0) {
+            fprintf(stderr, "Could not open %s: %s\n", path, strerror(errno));
+            return 1;
+        }
+    }
+
+    observer_t obs = {.fd = -1};
+    mb_freshness_init(&obs.fresh, 0);
+
+    const uint64_t start = now_ns();
+    cfg.end_ns = start + duration_s * NS_PER_SEC;
+
+    // MMC simulation or observer
+    pthread_t aux;
+    bool ok;
+    if (cfg.simulate) {
+        ok = !pthread_create(&aux, NULL, sim_mmc_thread, NULL);
+    } else {
+        obs.fd = open(path, O_RDONLY);
+        ok = obs.fd >= 0 && !pthread_create(&aux, NULL, observer_thread, &obs);
+    }
+    const bool aux_started = ok;
+    for (unsigned i = 0; ok && i < n_clients; i++) {
+        ok = !pthread_create(&clients[i].thread, NULL, client_thread, &clients[i]);
+        if (!ok) {
+            n_clients = i;
+        }
+    }
+    if (!ok) {
+        fprintf(stderr, "Could not start threads\n");
+    }
+
+    for (unsigned i = 0; i < n_clients; i++) {
+        pthread_join(clients[i].thread, NULL);
+        ok &= !clients[i].error;
+    }
+    const double duration = (double)(now_ns() - start) / NS_PER_SEC;
+    atomic_store(&stop, true);
+    if (aux_started) {
+        pthread_join(aux, NULL);
+    }
+    if (obs.fd >= 0) {
+        close(obs.fd);
+    }
+    if (!ok) {
+        fprintf(stderr, "Mailbox access failed\n");
+    }
+
+    report(clients, n_clients, duration, cfg.simulate ? NULL : &obs);
+
+    for (unsigned i = 0; i < n_clients; i++) {
+        if (clients[i].fd >= 0) {
+            close(clients[i].fd);
+        }
+        free(clients[i].lat_ns);
+    }
+    free(clients);
+    return ok ? 0 : 1;
+
+usage:
+    fprintf(stderr,
+            "usage: %s [-n clients] [-t seconds] [-p field|snapshot|mixed] [-i interval_ms]\r\n"
+            "          [-b bus_hz] [-s [-r image]]\r\n"
+            "The mixed pattern rewrites the NIC information; on a real mailbox an update\r\n"
+            "by mmcctrld can be lost, so stop mmcctrld or use the simulated bus (-s).\r\n",
+            argv[0]);
+    return 1;
+}
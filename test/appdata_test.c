@@ -0,0 +1,163 @@
+/***************************************************************************
+ *      ____  _____________  __    __  __ _           _____ ___   _        *
+ *     / __ \/ ____/ ___/\ \/ /   |  \/  (_)__ _ _ __|_   _/ __| /_\  (R)  *
+ *    / / / / __/  \__ \  \  /    | |\/| | / _| '_/ _ \| || (__ / _ \      *
+ *   / /_/ / /___ ___/ /  / /     |_|  |_|_\__|_| \___/|_| \___/_/ \_\     *
+ *  /_____/_____//____/  /_/      T  E  C  H  N  O  L  O  G  Y   L A B     *
+ *                                                                         *
+ *          Copyright 2022 Deutsches Elektronen-Synchrotron DESY.          *
+ *                          All rights reserved.                           *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+// Test: application data TLV parser, writer and change detection
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "mmcmb/mmcmb_appdata.h"
+
+#define CHECK(cond)                                                                 \
+    do {                                                                            \
+        if (!(cond)) {                                                              \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return false;                                                           \
+        }                                                                           \
+    } while (0)
+
+static bool test_records(void)
+{
+    uint8_t data[MB_APPDATA_SIZE];
+    mb_appdata_writer_t w;
+    mb_appdata_writer_init(&w, data);
+    const uint8_t u8 = 0x12;
+    const uint8_t u16[] = {0x34, 0x12};
+    const uint8_t u32[] = {0x78, 0x56, 0x34, 0x12};
+    const float f = 1.5f;
+    CHECK(mb_appdata_add(&w, 1, &u8, sizeof(u8)));
+    CHECK(mb_appdata_add(&w, 2, u16, sizeof(u16)));
+    CHECK(mb_appdata_add(&w, 3, u32, sizeof(u32)));
+    CHECK(mb_appdata_add(&w, 4, &f, sizeof(f)));
+    CHECK(mb_appdata_add(&w, 5, "serial", 6));
+    CHECK(!mb_appdata_add(&w, MB_APPDATA_END, &u8, sizeof(u8)));
+    CHECK(!mb_appdata_add(&w, MB_APPDATA_ERASED, &u8, sizeof(u8)));
+
+    mb_appdata_iter_t it;
+    mb_appdata_rec_t rec;
+    CHECK(mb_appdata_iter_init(&it, data));
+    int n = 0;
+    while (mb_appdata_next(&it, &rec)) {
+        CHECK(rec.type == ++n);
+    }
+    CHECK(n == 5 && !it.error);
+
+    uint8_t v8;
+    uint16_t v16;
+    uint32_t v32;
+    float vf;
+    char str[8];
+    CHECK(mb_appdata_find(data, 1, &rec) && mb_appdata_get_u8(&rec, &v8) && v8 == 0x12);
+    CHECK(!mb_appdata_get_u16(&rec, &v16));
+    CHECK(mb_appdata_find(data, 2, &rec) && mb_appdata_get_u16(&rec, &v16) && v16 == 0x1234);
+    CHECK(mb_appdata_find(data, 3, &rec) && mb_appdata_get_u32(&rec, &v32)
+          && v32 == 0x12345678);
+    CHECK(mb_appdata_find(data, 4, &rec) && mb_appdata_get_float(&rec, &vf) && vf == 1.5f);
+    CHECK(mb_appdata_find(data, 5, &rec) && mb_appdata_get_str(&rec, str, sizeof(str))
+          && !strcmp(str, "serial"));
+    CHECK(!mb_appdata_get_str(&rec, str, 6));
+    CHECK(!mb_appdata_find(data, 6, &rec));
+
+    // Erased memory ends the list too
+    data[w.pos] = MB_APPDATA_ERASED;
+    data[w.pos + 1] = 1;
+    n = 0;
+    CHECK(mb_appdata_iter_init(&it, data));
+    while (mb_appdata_next(&it, &rec)) {
+        n++;
+    }
+    CHECK(n == 5 && !it.error);
+
+    // No schema
+    data[0] = 'X';
+    CHECK(!mb_appdata_iter_init(&it, data));
+    CHECK(!mb_appdata_find(data, 1, &rec));
+    memcpy(data, MB_APPDATA_MAGIC, 2);
+    data[2] = MB_APPDATA_VERSION + 1;
+    CHECK(!mb_appdata_has_schema(data));
+    return true;
+}
+
+// Records overrunning the block are errors, the records before them are still returned
+static bool test_malformed(void)
+{
+    uint8_t data[MB_APPDATA_SIZE];
+    mb_appdata_writer_t w;
+    mb_appdata_iter_t it;
+    mb_appdata_rec_t rec;
+    static const uint8_t fill[MB_APPDATA_SIZE];
+
+    // Length byte beyond the remaining space
+    mb_appdata_writer_init(&w, data);
+    CHECK(mb_appdata_add(&w, 1, fill, 10));
+    data[w.pos] = 2;
+    data[w.pos + 1] = 0xfe;
+    CHECK(mb_appdata_iter_init(&it, data));
+    CHECK(mb_appdata_next(&it, &rec) && rec.type == 1 && rec.len == 10);
+    CHECK(!mb_appdata_next(&it, &rec) && it.error);
+    CHECK(!mb_appdata_next(&it, &rec));
+    CHECK(!mb_appdata_find(data, 2, &rec));
+
+    // Value ending one byte past the block
+    mb_appdata_writer_init(&w, data);
+    const uint8_t len = MB_APPDATA_SIZE - MB_APPDATA_HDR_SIZE - 2;
+    CHECK(!mb_appdata_add(&w, 1, fill, len + 1));
+    CHECK(mb_appdata_add(&w, 1, fill, len));
+    CHECK(mb_appdata_iter_init(&it, data));
+    CHECK(mb_appdata_next(&it, &rec) && rec.len == len);
+    CHECK(!mb_appdata_next(&it, &rec) && !it.error);
+    data[MB_APPDATA_HDR_SIZE + 1] = len + 1;
+    CHECK(mb_appdata_iter_init(&it, data));
+    CHECK(!mb_appdata_next(&it, &rec) && it.error);
+
+    // Record header truncated by the end of the block
+    mb_appdata_writer_init(&w, data);
+    CHECK(mb_appdata_add(&w, 1, fill, len - 1));
+    data[MB_APPDATA_SIZE - 1] = 2;
+    CHECK(mb_appdata_iter_init(&it, data));
+    CHECK(mb_appdata_next(&it, &rec) && rec.len == len - 1);
+    CHECK(!mb_appdata_next(&it, &rec) && it.error);
+    return true;
+}
+
+static bool test_changed(void)
+{
+    uint8_t data[MB_APPDATA_SIZE];
+    mb_appdata_writer_t w;
+    mb_appdata_writer_init(&w, data);
+    CHECK(mb_appdata_add(&w, 1, "a", 1));
+
+    mb_appdata_watch_t watch;
+    mb_appdata_watch_init(&watch);
+    CHECK(mb_appdata_changed(&watch, data));
+    CHECK(!mb_appdata_changed(&watch, data));
+    data[MB_APPDATA_HDR_SIZE + 2] = 'b';
+    CHECK(mb_appdata_changed(&watch, data));
+    CHECK(!mb_appdata_changed(&watch, data));
+    data[MB_APPDATA_SIZE - 1] ^= 1;
+    CHECK(mb_appdata_changed(&watch, data));
+
+    // Blocks without a schema are watched as well
+    data[0] = 0;
+    CHECK(mb_appdata_changed(&watch, data));
+    CHECK(!mb_appdata_changed(&watch, data));
+    return true;
+}
+
+int main(void)
+{
+    return test_records() && test_malformed() && test_changed() ? 0 : 1;
+}
@@ -0,0 +1,58 @@
+/***************************************************************************
+ *      ____  _____________  __    __  __ _           _____ ___   _        *
+ *     / __ \/ ____/ ___/\ \/ /   |  \/  (_)__ _ _ __|_   _/ __| /_\  (R)  *
+ *    / / / / __/  \__ \  \  /    | |\/| | / _| '_/ _ \| || (__ / _ \      *
+ *   / /_/ / /___ ___/ /  / /     |_|  |_|_\__|_| \___/|_| \___/_/ \_\     *
+ *  /_____/_____//____/  /_/      T  E  C  H  N  O  L  O  G  Y   L A B     *
+ *                                                                         *
+ *          Copyright 2022 Deutsches Elektronen-Synchrotron DESY.          *
+ *                          All rights reserved.                           *
+ *                                                                         *
+ ***************************************************************************/
+
+
+// Test helper: write an archive of synthetic snapshots, one per timestamp argument.
+// Snapshot i has the MMC sensors TEMP = i and TEMP_FPGA = 100 + i.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mmcmb/fpga_mailbox_layout.h"
+#include "mmcmb/mmcmb_archive.h"
+
+#define NS_PER_SEC 1000000000ull
+
+int main(int argc, char** argv)
+{
+    if (argc < 4) {
+        fprintf(stderr, "usage: %s <file> <keyframe_interval> <timestamp>...\n", argv[0]);
+        return 1;
+    }
+
+    mb_archive_writer_t* w = mb_archive_create(argv[1], strtoul(argv[2], NULL, 0));
+    if (!w) {
+        return 1;
+    }
+
+    mb_memory_contents_t snap;
+    memset(&snap, 0, sizeof(snap));
+    memcpy(snap.mailbox_magic_str, MB_MAGIC_STR, sizeof(snap.mailbox_magic_str));
+    snap.mailbox_version = MB_VERSION_MAX;
+    strcpy(snap.mmc_sensor[0].name, "TEMP");
+    strcpy(snap.mmc_sensor[1].name, "TEMP_FPGA");
+
+    for (int i = 3; i < argc; i++) {
+        snap.mmc_sensor[0].reading = i - 3;
+        snap.mmc_sensor[1].reading = 100 + i - 3;
+        snap.mmc_information.mmc_uptime = i - 3;
+        const uint64_t t_ns = strtod(argv[i], NULL) * NS_PER_SEC;
+        if (!mb_archive_append(w, t_ns, &snap)) {
+            mb_archive_finish(w);
+            return 1;
+        }
+    }
+    return mb_archive_finish(w) ? 0 : 1;
+}
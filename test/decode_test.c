@@ -0,0 +1,116 @@
+/***************************************************************************
+ *      ____  _____________  __    __  __ _           _____ ___   _        *
+ *     / __ \/ ____/ ___/\ \/ /   |  \/  (_)__ _ _ __|_   _/ __| /_\  (R)  *
+ *    / / / / __/  \__ \  \  /    | |\/| | / _| '_/ _ \| || (__ / _ \      *
+ *   / /_/ / /___ ___/ /  / /     |_|  |_|_\__|_| \___/|_| \___/_/ \_\     *
+ *  /_____/_____//____/  /_/      T  E  C  H  N  O  L  O  G  Y   L A B     *
+ *                                                                         *
+ *          Copyright 2022 Deutsches Elektronen-Synchrotron DESY.          *
+ *                          All rights reserved.                           *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+// Test: decoding raw snapshots into native types
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "mmcmb/fpga_mailbox_layout.h"
+#include "mmcmb/mmcmb_decode.h"
+
+#define CHECK(cond)                                                                 \
+    do {                                                                            \
+        if (!(cond)) {                                                              \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return false;                                                           \
+        }                                                                           \
+    } while (0)
+
+static void make_snapshot(mb_memory_contents_t* mb, uint8_t version)
+{
+    memset(mb, 0, sizeof(*mb));
+    memcpy(mb->mailbox_magic_str, MB_MAGIC_STR, sizeof(mb->mailbox_magic_str));
+    mb->mailbox_version = version;
+
+    mb_fru_status_t* stat = &mb->fru_information[2].status;
+    stat->present = 1;
+    stat->powered = 1;
+    stat->ext.fmc.clk_dir = 1;
+    stat->num_temp_sensors = 3;
+    stat->temperature[0] = 2550;               // 25.5
+    stat->temperature[1] = (uint16_t)(-1025);  // -10.25
+    stat->temperature[2] = FRU_TEMP_INVALID;
+    stat->temperature[3] = 1000;  // Beyond num_temp_sensors
+    mb->fru_information[3].status.num_temp_sensors = MAX_SENS_PER_FRU + 5;
+
+    mb_mmc_information_t* info = &mb->mmc_information;
+    info->application_version.major = 1;
+    info->application_version.minor = 2;
+    info->amc_slot_nr = 5;
+    info->ipmb_addr = 0x7a;
+    memset(info->board_name, 'B', sizeof(info->board_name));  // Unterminated
+    info->vendor_id = 0x1234;
+    info->product_id = 0xabcd;
+    info->mmc_uptime = 0x01020304;
+    info->amc_hw_revision = 'C';
+
+    strcpy(mb->mmc_sensor[0].name, "TEMP");
+    mb->mmc_sensor[0].reading = 42.5f;
+    memset(mb->mmc_sensor[1].name, 'S', sizeof(mb->mmc_sensor[1].name));
+    mb->mmc_sensor[1].reading = NAN;
+    strcpy(mb->mmc_sensor[3].name, "AFTER_GAP");
+}
+
+static bool test_decode(void)
+{
+    mb_memory_contents_t raw;
+    mb_decoded_t dec;
+    make_snapshot(&raw, 3);
+    CHECK(mb_decode_snapshot(&raw, &dec));
+    CHECK(dec.mailbox_version == 3);
+
+    const mb_fru_status_decoded_t* stat = &dec.fru_status[2];
+    CHECK(stat->present && !stat->compatible && stat->powered && !stat->failure);
+    CHECK(stat->clk_dir && !stat->hspc_prsnt && !stat->pg_m2c);
+    CHECK(stat->num_temp_sensors == 3);
+    CHECK(stat->temperature[0] == 25.5f && stat->temperature[1] == -10.25f);
+    CHECK(isnan(stat->temperature[2]) && isnan(stat->temperature[3]));
+    CHECK(dec.fru_status[3].num_temp_sensors == MAX_SENS_PER_FRU);
+    CHECK(!dec.fru_status[0].present && dec.fru_status[0].num_temp_sensors == 0);
+
+    const mb_mmc_information_decoded_t* info = &dec.mmc_information;
+    CHECK(info->application_version.major == 1 && info->application_version.minor == 2);
+    CHECK(info->amc_slot_nr == 5 && info->ipmb_addr == 0x7a);
+    CHECK(strlen(info->board_name) == sizeof(raw.mmc_information.board_name));
+    CHECK(info->vendor_id == 0x1234 && info->product_id == 0xabcd);
+    CHECK(info->mmc_uptime == 0x01020304);
+    CHECK(info->amc_hw_revision == 'C');
+
+    // Sensors are counted up to the first unnamed slot, names are terminated
+    CHECK(dec.num_mmc_sensors == 2);
+    CHECK(!strcmp(dec.mmc_sensor[0].name, "TEMP") && dec.mmc_sensor[0].reading == 42.5f);
+    CHECK(strlen(dec.mmc_sensor[1].name) == sizeof(raw.mmc_sensor[1].name));
+    CHECK(isnan(dec.mmc_sensor[1].reading));
+    CHECK(!strcmp(dec.mmc_sensor[3].name, "AFTER_GAP"));
+
+    // Fields a mailbox version doesn't define decode as zero
+    make_snapshot(&raw, 2);
+    CHECK(mb_decode_snapshot(&raw, &dec));
+    CHECK(dec.mailbox_version == 2 && dec.mmc_information.amc_hw_revision == '\0');
+    CHECK(dec.mmc_information.mmc_uptime == 0x01020304);
+
+    // Unsupported versions
+    make_snapshot(&raw, MB_VERSION_MAX + 1);
+    CHECK(!mb_decode_snapshot(&raw, &dec));
+    return true;
+}
+
+int main(void)
+{
+    return test_decode() ? 0 : 1;
+}
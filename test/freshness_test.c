@@ -0,0 +1,128 @@
+/***************************************************************************
+ *      ____  _____________  __    __  __ _           _____ ___   _        *
+ *     / __ \/ ____/ ___/\ \/ /   |  \/  (_)__ _ _ __|_   _/ __| /_\  (R)  *
+ *    / / / / __/  \__ \  \  /    | |\/| | / _| '_/ _ \| || (__ / _ \      *
+ *   / /_/ / /___ ___/ /  / /     |_|  |_|_\__|_| \___/|_| \___/_/ \_\     *
+ *  /_____/_____//____/  /_/      T  E  C  H  N  O  L  O  G  Y   L A B     *
+ *                                                                         *
+ *          Copyright 2022 Deutsches Elektronen-Synchrotron DESY.          *
+ *                          All rights reserved.                           *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+// Test: freshness monitor state machine, driven with synthetic uptimes and timestamps
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "mmcmb/fpga_mailbox_layout.h"
+#include "mmcmb/mmcmb_freshness.h"
+
+#define CHECK(cond)                                                                 \
+    do {                                                                            \
+        if (!(cond)) {                                                              \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return false;                                                           \
+        }                                                                           \
+    } while (0)
+
+#define MS(ms) ((uint64_t)(ms) * 1000000ull)
+
+// Monotonic clock start, arbitrary but non-zero
+#define T0 MS(1000000)
+
+static bool test_stall(void)
+{
+    mb_freshness_t f;
+    mb_freshness_init(&f, 0);
+    CHECK(f.stale_ms == MB_FRESHNESS_DEFAULT_STALE_MS);
+    mb_freshness_init(&f, 3000);
+    CHECK(f.state == MB_FRESHNESS_UNKNOWN);
+
+    // Uptime advancing once per second
+    uint32_t uptime = 100;
+    uint64_t t = T0;
+    CHECK(mb_freshness_update(&f, uptime, t) == MB_FRESHNESS_FRESH);
+    for (int i = 0; i < 5; i++) {
+        t += MS(1000);
+        CHECK(mb_freshness_update(&f, ++uptime, t) == MB_FRESHNESS_FRESH);
+    }
+
+    // Uptime not advancing: fresh up to stale_ms, stale after that
+    const uint64_t change = t;
+    for (t = change + MS(500); t <= change + MS(3000); t += MS(500)) {
+        CHECK(mb_freshness_update(&f, uptime, t) == MB_FRESHNESS_FRESH);
+    }
+    CHECK(mb_freshness_update(&f, uptime, change + MS(3001)) == MB_FRESHNESS_STALE);
+    CHECK(mb_freshness_age_ms(&f, change + MS(3001)) == 3001);
+    CHECK(mb_freshness_update(&f, uptime, change + MS(9000)) == MB_FRESHNESS_STALE);
+    CHECK(f.stale_events == 1);
+
+    // Advancing again clears it; the MMC uptime fell behind the wall clock: MMC stall
+    t = change + MS(10000);
+    CHECK(mb_freshness_update(&f, ++uptime, t) == MB_FRESHNESS_FRESH);
+    CHECK(f.mmc_stalls == 1 && f.held_back == 0);
+    CHECK(mb_freshness_age_ms(&f, t) == 0);
+
+    // Stale again, but the uptime kept up with the wall clock: updates were held back
+    t += MS(5000);
+    CHECK(mb_freshness_update(&f, uptime, t) == MB_FRESHNESS_STALE);
+    CHECK(f.stale_events == 2);
+    uptime += 5;
+    CHECK(mb_freshness_update(&f, uptime, t) == MB_FRESHNESS_FRESH);
+    CHECK(f.mmc_stalls == 1 && f.held_back == 1);
+    return true;
+}
+
+static bool test_restart(void)
+{
+    mb_freshness_t f;
+    mb_freshness_init(&f, 3000);
+    uint64_t t = T0;
+    CHECK(mb_freshness_update(&f, 1000, t) == MB_FRESHNESS_FRESH);
+
+    // Uptime going backwards restarts the monitor, without counting as stale
+    t += MS(1000);
+    CHECK(mb_freshness_update(&f, 2, t) == MB_FRESHNESS_RESTARTED);
+    CHECK(f.mmc_restarts == 1 && f.stale_events == 0);
+    t += MS(500);
+    CHECK(mb_freshness_update(&f, 2, t) == MB_FRESHNESS_FRESH);
+    CHECK(mb_freshness_update(&f, 2, t + MS(3001)) == MB_FRESHNESS_STALE);
+    return true;
+}
+
+static bool test_rate_and_sensors(void)
+{
+    mb_freshness_t f;
+    mb_freshness_init(&f, 3000);
+    uint64_t t = T0;
+    uint32_t uptime = 0;
+    mb_freshness_update(&f, uptime, t);
+    for (int i = 0; i < 20; i++) {
+        t += MS(500);
+        uptime += i % 2;
+        mb_freshness_update(&f, uptime, t);
+    }
+    CHECK(f.update_rate_hz > 0.99 && f.update_rate_hz < 1.01);
+
+    mb_mmc_sensor_t sen[2];
+    memset(sen, 0, sizeof(sen));
+    t = T0;
+    mb_freshness_update_sensors(&f, sen, 2, t);
+    CHECK(mb_freshness_sensor_age_ms(&f, t + MS(2000)) == 2000);
+    mb_freshness_update_sensors(&f, sen, 2, t + MS(2000));
+    CHECK(mb_freshness_sensor_age_ms(&f, t + MS(2000)) == 2000);
+    sen[1].reading = 1.f;
+    mb_freshness_update_sensors(&f, sen, 2, t + MS(3000));
+    CHECK(mb_freshness_sensor_age_ms(&f, t + MS(3500)) == 500);
+    return true;
+}
+
+int main(void)
+{
+    return test_stall() && test_restart() && test_rate_and_sensors() ? 0 : 1;
+}
@@ -0,0 +1,77 @@
+#!/bin/sh
+# Record synthetic snapshots into an archive and read them back with mmcarchive
+mmcarchive="$1"
+archive_gen="$2"
+dir=$(mktemp -d) || exit 1
+trap 'rm -rf "$dir"' EXIT
+
+fail() {
+    echo "$1"
+    exit 1
+}
+
+# Check the output of "mmcarchive <args>" against the expected lines
+check() {
+    expected="$1"
+    shift
+    out=$("$mmcarchive" "$@" 2>"$dir/stderr") || fail "mmcarchive $* failed: $(cat "$dir/stderr")"
+    [ "$out" = "$expected" ] || fail "mmcarchive $*:
+$out
+expected:
+$expected"
+}
+
+# 10 snapshots, keyframes at 1, 5 and 9 s; TEMP = 0..9, TEMP_FPGA = 100..109
+"$archive_gen" "$dir/a.arc" 4 1 2 3 4 5 6 7 8 9 10 || fail "archive_gen failed"
+
+info="Keyframes : 3
+First     : 1.000
+Last      : 10.000
+Duration  : 9.000 s"
+all="timestamp,TEMP
+1.000,0
+2.000,1
+3.000,2
+4.000,3
+5.000,4
+6.000,5
+7.000,6
+8.000,7
+9.000,8
+10.000,9"
+range="timestamp,TEMP
+3.000,2
+4.000,3
+5.000,4
+6.000,5"
+
+check "$info" info "$dir/a.arc"
+check "$all" extract "$dir/a.arc" TEMP
+# Starts between keyframes, so deltas are applied before the first reported frame
+check "$range" extract "$dir/a.arc" TEMP 3 6
+# Whole names only, TEMP must not match TEMP_FPGA
+check "timestamp,TEMP_FPGA
+4.000,103" extract "$dir/a.arc" TEMP_FPGA 4 4
+check "timestamp,TEMP_F" extract "$dir/a.arc" TEMP_F
+
+# Keyframe sharing its timestamp with the preceding deltas (frames 2..4 at 3 s)
+"$archive_gen" "$dir/t.arc" 3 1 2 3 3 3 4 || fail "archive_gen failed"
+check "timestamp,TEMP
+3.000,2
+3.000,3
+3.000,4" extract "$dir/t.arc" TEMP 3 3
+
+# Corrupt the last index entry (frame offset): the index is rebuilt by a scan
+size=$(wc -c < "$dir/a.arc")
+cp "$dir/a.arc" "$dir/b.arc"
+printf '\377' | dd of="$dir/b.arc" bs=1 seek=$((size - 2)) conv=notrunc 2>/dev/null
+check "$info" info "$dir/b.arc"
+check "$range" extract "$dir/b.arc" TEMP 3 6
+grep -q "index corrupt" "$dir/stderr" || fail "corrupt index not detected"
+
+# Unfinished archive: no index, index offset in the header is 0
+head -c $((size - 8 - 3 * 16)) "$dir/a.arc" > "$dir/c.arc"
+printf '\0\0\0\0\0\0\0\0' | dd of="$dir/c.arc" bs=1 seek=16 conv=notrunc 2>/dev/null
+check "$info" info "$dir/c.arc"
+check "$all" extract "$dir/c.arc" TEMP
+exit 0
@@ -0,0 +1,16 @@
+#!/bin/sh
+# mmcinfo -d has to show a change in the last byte of a 256-byte field (application_data)
+mmcinfo="$1"
+dir=$(mktemp -d) || exit 1
+trap 'rm -rf "$dir"' EXIT
+
+{ printf 'MMCMBOX\003'; head -c 2039 /dev/zero; } > "$dir/a.img"
+cp "$dir/a.img" "$dir/b.img"
+# application_data[255] = 0xab
+printf '\253' | dd of="$dir/b.img" bs=1 seek=1287 conv=notrunc 2>/dev/null
+
+out=$("$mmcinfo" -d "$dir/a.img" "$dir/b.img")
+status=$?
+echo "$out"
+[ "$status" -eq 1 ] || { echo "exit code $status, expected 1"; exit 1; }
+echo "$out" | grep -q '^application_data .*: 0\{512\} -> 0\{510\}ab$' || exit 1
@@ -0,0 +1,13 @@
+#!/bin/sh
+# mmcinfo has to show FRU temperatures as signed values (s16, 0.01 deg. C)
+mmcinfo="$1"
+dir=$(mktemp -d) || exit 1
+trap 'rm -rf "$dir"' EXIT
+
+{ printf 'MMCMBOX\003'; head -c 2039 /dev/zero; } > "$dir/a.img"
+# FRU 0: present, 1 temperature sensor, temperature[0] = -550 (0xfdda)
+printf '\001\001\332\375' | dd of="$dir/a.img" bs=1 seek=8 conv=notrunc 2>/dev/null
+
+out=$("$mmcinfo" -r "$dir/a.img" fru0) || exit 1
+echo "$out"
+echo "$out" | grep -q '^Temperature 1 : -5.5 C$' || exit 1
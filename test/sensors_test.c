@@ -0,0 +1,145 @@
+/***************************************************************************
+ *      ____  _____________  __    __  __ _           _____ ___   _        *
+ *     / __ \/ ____/ ___/\ \/ /   |  \/  (_)__ _ _ __|_   _/ __| /_\  (R)  *
+ *    / / / / __/  \__ \  \  /    | |\/| | / _| '_/ _ \| || (__ / _ \      *
+ *   / /_/ / /___ ___/ /  / /     |_|  |_|_\__|_| \___/|_| \___/_/ \_\     *
+ *  /_____/_____//____/  /_/      T  E  C  H  N  O  L  O  G  Y   L A B     *
+ *                                                                         *
+ *          Copyright 2022 Deutsches Elektronen-Synchrotron DESY.          *
+ *                          All rights reserved.                           *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+// Test: name-indexed MMC sensor lookup, on a sensor table and on a mailbox image
+
+#include <fcntl.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "mmcmb/fpga_mailbox_layout.h"
+#include "mmcmb/mmcmb.h"
+#include "mmcmb/mmcmb_sensors.h"
+
+#define CHECK(cond)                                                                 \
+    do {                                                                            \
+        if (!(cond)) {                                                              \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return false;                                                           \
+        }                                                                           \
+    } while (0)
+
+static void set_name(mb_mmc_sensor_t* sen, const char* name)
+{
+    memset(sen->name, 0, sizeof(sen->name));
+    memcpy(sen->name, name, strnlen(name, sizeof(sen->name)));
+}
+
+static bool test_index(void)
+{
+    mb_mmc_sensor_t sen[MAX_SENS_MMC];
+    memset(sen, 0, sizeof(sen));
+    for (size_t i = 0; i < MAX_SENS_MMC; i += 2) {
+        char name[16];
+        snprintf(name, sizeof(name), "S%zu", i);
+        set_name(&sen[i], name);
+    }
+    set_name(&sen[1], "TEMP");
+    set_name(&sen[3], "TEMP_FPGA");
+    set_name(&sen[5], "TWELVE_CHARS");  // Fills the field, no terminator
+    set_name(&sen[7], "TEMP");          // Duplicate
+
+    mb_sensor_index_t idx;
+    mb_sensor_index_build(&idx, sen);
+    for (size_t i = 0; i < MAX_SENS_MMC; i += 2) {
+        char name[16];
+        snprintf(name, sizeof(name), "S%zu", i);
+        CHECK(mb_sensor_index_find(&idx, name) == (int)i);
+    }
+    CHECK(mb_sensor_index_find(&idx, "TEMP") == 1);
+    CHECK(mb_sensor_index_find(&idx, "TEMP_FPGA") == 3);
+    CHECK(mb_sensor_index_find(&idx, "TWELVE_CHARS") == 5);
+
+    // Only whole names match
+    CHECK(mb_sensor_index_find(&idx, "TEMP_F") == -1);
+    CHECK(mb_sensor_index_find(&idx, "TEM") == -1);
+    CHECK(mb_sensor_index_find(&idx, "TWELVE_CHARSX") == -1);
+    CHECK(mb_sensor_index_find(&idx, "") == -1);
+    CHECK(mb_sensor_index_find(&idx, "S1") == -1);
+
+    // Renamed slots are picked up by an update, unchanged tables don't rebuild
+    CHECK(!mb_sensor_index_update(&idx, sen));
+    set_name(&sen[1], "VOLT");
+    CHECK(mb_sensor_index_update(&idx, sen));
+    CHECK(mb_sensor_index_find(&idx, "VOLT") == 1);
+    CHECK(mb_sensor_index_find(&idx, "TEMP") == 7);
+    return true;
+}
+
+static bool write_sensor(int fd, size_t slot, const char* name, float reading)
+{
+    mb_mmc_sensor_t sen;
+    set_name(&sen, name);
+    sen.reading = reading;
+    const off_t offs = MB_EEPROM_OFFS(mmc_sensor) + slot * sizeof(sen);
+    CHECK(pwrite(fd, &sen, sizeof(sen), offs) == sizeof(sen));
+    return true;
+}
+
+static bool test_mailbox(const char* path)
+{
+    mb_memory_contents_t mb;
+    memset(&mb, 0, sizeof(mb));
+    memcpy(mb.mailbox_magic_str, MB_MAGIC_STR, sizeof(mb.mailbox_magic_str));
+    mb.mailbox_version = MB_VERSION_MAX;
+    const int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    CHECK(fd >= 0);
+    CHECK(write(fd, &mb, sizeof(mb)) == sizeof(mb));
+    CHECK(write_sensor(fd, 0, "TEMP", 30.f));
+    CHECK(write_sensor(fd, 10, "VOLT", 12.f));
+    CHECK(write_sensor(fd, 11, "CURR", 2.f));
+    CHECK(mb_set_eeprom_path(path));
+
+    CHECK(mb_find_sensor("VOLT") == 10);
+    CHECK(mb_find_sensor("NONE") == -1);
+
+    mb_mmc_sensor_t sen[3];
+    const char* const names[] = {"CURR", "NONE", "TEMP"};
+    CHECK(mb_get_mmc_sensors_by_name(sen, names, 3));
+    CHECK(!strcmp(sen[0].name, "CURR") && sen[0].reading == 2.f);
+    CHECK(!sen[1].name[0] && isnan(sen[1].reading));
+    CHECK(!strcmp(sen[2].name, "TEMP") && sen[2].reading == 30.f);
+
+    // Sensor table changed (e.g. MMC firmware update): the slot carries another name now
+    CHECK(write_sensor(fd, 0, "FAN", 1000.f));
+    CHECK(write_sensor(fd, 5, "TEMP", 31.f));
+    const char* const temp[] = {"TEMP"};
+    CHECK(mb_get_mmc_sensors_by_name(sen, temp, 1));
+    CHECK(!strcmp(sen[0].name, "TEMP") && sen[0].reading == 31.f);
+    CHECK(mb_find_sensor("TEMP") == 5);
+
+    close(fd);
+    return true;
+}
+
+int main(void)
+{
+    char path[] = "/tmp/mmcsensors.XXXXXX";
+    const int fd = mkstemp(path);
+    if (fd < 0) {
+        perror("mkstemp");
+        return 1;
+    }
+    close(fd);
+
+    const bool ok = test_index() && test_mailbox(path);
+    unlink(path);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,292 @@
+/***************************************************************************
+ *      ____  _____________  __    __  __ _           _____ ___   _        *
+ *     / __ \/ ____/ ___/\ \/ /   |  \/  (_)__ _ _ __|_   _/ __| /_\  (R)  *
+ *    / / / / __/  \__ \  \  /    | |\/| | / _| '_/ _ \| || (__ / _ \      *
+ *   / /_/ / /___ ___/ /  / /     |_|  |_|_\__|_| \___/|_| \___/_/ \_\     *
+ *  /_____/_____//____/  /_/      T  E  C  H  N  O  L  O  G  Y   L A B     *
+ *                                                                         *
+ *          Copyright 2022 Deutsches Elektronen-Synchrotron DESY.          *
+ *                          All rights reserved.                           *
+ *                                                                         *
+ ***************************************************************************/
+
+
+// Test: snapshot stream framing, and a board streamed through mmccrated (keyframe, delta,
+// publisher reconnect) arriving byte for byte at a collector client.
+// usage: stream_collector_test <mmccrated>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "mmcmb/fpga_mailbox_layout.h"
+#include "mmcmb/mmcmb_stream.h"
+
+#define TIMEOUT_MS 5000
+
+extern char** environ;
+
+#define CHECK(cond)                                                                 \
+    do {                                                                            \
+        if (!(cond)) {                                                              \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return false;                                                           \
+        }                                                                           \
+    } while (0)
+
+static void make_snapshot(mb_memory_contents_t* snap, uint32_t uptime)
+{
+    memset(snap, 0, sizeof(*snap));
+    memcpy(snap->mailbox_magic_str, MB_MAGIC_STR, sizeof(snap->mailbox_magic_str));
+    snap->mailbox_version = MB_VERSION_MAX;
+    snap->mmc_information.amc_slot_nr = 5;
+    snap->mmc_information.ipmb_addr = 0x7a;
+    strcpy(snap->mmc_information.board_name, "TEST");
+    snap->mmc_information.mmc_uptime = uptime;
+    for (size_t i = 0; i < sizeof(snap->application_data); i++) {
+        snap->application_data[i] = (uint8_t)(i * 7 + uptime);
+    }
+}
+
+/* Framing */
+
+static bool test_framing(void)
+{
+    int sv[2];
+    CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+    CHECK(fcntl(sv[1], F_SETFL, O_NONBLOCK) == 0);
+
+    mb_memory_contents_t snap, rcvd;
+    make_snapshot(&snap, 1);
+    const mb_stream_hdr_t hdr = {
+        .magic = MB_STREAM_MAGIC,
+        .type = MB_STREAM_KEYFRAME,
+        .payload_len = sizeof(snap),
+        .timestamp_ns = 42,
+    };
+
+    // A message split across writes is only complete after the last byte
+    mb_stream_rx_t rx;
+    mb_stream_rx_init(&rx);
+    CHECK(mb_stream_recv(&rx, sv[1]) == 0);
+    CHECK(write(sv[0], &hdr, 10) == 10);
+    CHECK(mb_stream_recv(&rx, sv[1]) == 0);
+    CHECK(write(sv[0], (const uint8_t*)&hdr + 10, sizeof(hdr) - 10) == sizeof(hdr) - 10);
+    CHECK(write(sv[0], &snap, 100) == 100);
+    CHECK(mb_stream_recv(&rx, sv[1]) == 0);
+    CHECK(write(sv[0], (const uint8_t*)&snap + 100, sizeof(snap) - 100)
+          == sizeof(snap) - 100);
+    CHECK(mb_stream_recv(&rx, sv[1]) == 1);
+    CHECK(rx.hdr.timestamp_ns == 42);
+    CHECK(mb_stream_apply(&rx, &rcvd));
+    CHECK(!memcmp(&rcvd, &snap, sizeof(snap)));
+
+    // Delta against the previous snapshot
+    mb_memory_contents_t next;
+    make_snapshot(&next, 2);
+    mb_stream_rx_init(&rx);
+    CHECK(mb_stream_send_snapshot(sv[0], 43, &snap, &next));
+    CHECK(mb_stream_recv(&rx, sv[1]) == 1);
+    CHECK(rx.hdr.type == MB_STREAM_DELTA && rx.hdr.payload_len < sizeof(next));
+    CHECK(mb_stream_apply(&rx, &rcvd));
+    CHECK(!memcmp(&rcvd, &next, sizeof(next)));
+
+    // Bad magic and oversized payloads are protocol errors
+    mb_stream_hdr_t bad = hdr;
+    bad.magic = 0;
+    mb_stream_rx_init(&rx);
+    CHECK(write(sv[0], &bad, sizeof(bad)) == sizeof(bad));
+    CHECK(mb_stream_recv(&rx, sv[1]) == -1);
+    bad = hdr;
+    bad.payload_len = MB_STREAM_MAX_PAYLOAD + 1;
+    mb_stream_rx_init(&rx);
+    CHECK(write(sv[0], &bad, sizeof(bad)) == sizeof(bad));
+    CHECK(mb_stream_recv(&rx, sv[1]) == -1);
+
+    // EOF
+    close(sv[0]);
+    mb_stream_rx_init(&rx);
+    CHECK(mb_stream_recv(&rx, sv[1]) == -1);
+    close(sv[1]);
+    return true;
+}
+
+/* Collector */
+
+static void set_addr(struct sockaddr_un* addr, const char* path)
+{
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    memcpy(addr->sun_path, path, strnlen(path, sizeof(addr->sun_path) - 1));
+}
+
+static int listen_on(const char* path)
+{
+    struct sockaddr_un addr;
+    set_addr(&addr, path);
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(fd, 1) < 0) {
+        perror("listen");
+        return -1;
+    }
+    return fd;
+}
+
+// Wait for mmccrated to connect to the publisher socket
+static int accept_collector(int listen_fd)
+{
+    struct pollfd pfd = {.fd = listen_fd, .events = POLLIN};
+    if (poll(&pfd, 1, TIMEOUT_MS) != 1) {
+        return -1;
+    }
+    return accept(listen_fd, NULL, NULL);
+}
+
+static int connect_client(const char* path)
+{
+    struct sockaddr_un addr;
+    set_addr(&addr, path);
+    for (int i = 0; i < TIMEOUT_MS / 10; i++) {
+        const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+        if (fd >= 0 && connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0) {
+            return fd;
+        }
+        close(fd);
+        usleep(10000);
+    }
+    return -1;
+}
+
+typedef struct client {
+    int fd;
+    mb_stream_rx_t rx;
+    bool valid;  // Board known
+    mb_memory_contents_t board;
+} client_t;
+
+// Apply the collector's messages until the board is <expected> (NULL: removed)
+static bool client_wait(client_t* c, const mb_memory_contents_t* expected)
+{
+    for (int elapsed = 0; elapsed < TIMEOUT_MS; elapsed += 10) {
+        int ret;
+        while ((ret = mb_stream_recv(&c->rx, c->fd)) > 0) {
+            const mb_stream_hdr_t* hdr = &c->rx.hdr;
+            if (hdr->type == MB_STREAM_REMOVE) {
+                c->valid = false;
+            } else if (hdr->type != MB_STREAM_SYNC) {
+                CHECK(hdr->amc_slot_nr == 5 && hdr->ipmb_addr == 0x7a);
+                CHECK(hdr->type == MB_STREAM_KEYFRAME || c->valid);
+                CHECK(mb_stream_apply(&c->rx, &c->board));
+                c->valid = true;
+            }
+            mb_stream_rx_init(&c->rx);
+        }
+        CHECK(ret == 0);
+        if (expected ? c->valid && !memcmp(&c->board, expected, sizeof(*expected)) : !c->valid) {
+            return true;
+        }
+        struct pollfd pfd = {.fd = c->fd, .events = POLLIN};
+        poll(&pfd, 1, 10);
+    }
+    fprintf(stderr, "timeout waiting for the %s\n", expected ? "snapshot" : "board removal");
+    return false;
+}
+
+static bool test_collector(const char* mmccrated, const char* dir)
+{
+    char pub_path[256], crate_path[256];
+    snprintf(pub_path, sizeof(pub_path), "%s/pub.sock", dir);
+    snprintf(crate_path, sizeof(crate_path), "%s/crate.sock", dir);
+
+    const int listen_fd = listen_on(pub_path);
+    CHECK(listen_fd >= 0);
+
+    char* const argv[] = {(char*)mmccrated, "-l", crate_path, pub_path, NULL};
+    pid_t pid;
+    CHECK(posix_spawn(&pid, mmccrated, NULL, NULL, argv, environ) == 0);
+
+    bool ok = false;
+    client_t c = {.fd = -1};
+    mb_memory_contents_t s1, s2, s3;
+    make_snapshot(&s1, 1);
+    make_snapshot(&s2, 2);
+    make_snapshot(&s3, 100);
+
+    int pub_fd = accept_collector(listen_fd);
+    if (pub_fd < 0) {
+        fprintf(stderr, "mmccrated didn't connect\n");
+        goto out;
+    }
+    if (!mb_stream_send_snapshot(pub_fd, 1, NULL, &s1)) {
+        goto out;
+    }
+    c.fd = connect_client(crate_path);
+    mb_stream_rx_init(&c.rx);
+    if (c.fd < 0 || !client_wait(&c, &s1)) {
+        goto out;
+    }
+
+    // Delta
+    if (!mb_stream_send_snapshot(pub_fd, 2, &s1, &s2) || !client_wait(&c, &s2)) {
+        goto out;
+    }
+
+    // Publisher restart: the board is removed, then comes back after the reconnect
+    close(pub_fd);
+    if (!client_wait(&c, NULL)) {
+        goto out;
+    }
+    pub_fd = accept_collector(listen_fd);
+    if (pub_fd < 0) {
+        fprintf(stderr, "mmccrated didn't reconnect\n");
+        goto out;
+    }
+    ok = mb_stream_send_snapshot(pub_fd, 3, NULL, &s3) && client_wait(&c, &s3);
+
+out:
+    if (pub_fd >= 0) {
+        close(pub_fd);
+    }
+    if (c.fd >= 0) {
+        close(c.fd);
+    }
+    close(listen_fd);
+    kill(pid, SIGTERM);
+    waitpid(pid, NULL, 0);
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <mmccrated>\n", argv[0]);
+        return 1;
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    char dir[] = "/tmp/mmcstream.XXXXXX";
+    if (!mkdtemp(dir)) {
+        perror("mkdtemp");
+        return 1;
+    }
+
+    const bool ok = test_framing() && test_collector(argv[1], dir);
+
+    char path[256];
+    snprintf(path, sizeof(path), "%s/pub.sock", dir);
+    unlink(path);
+    snprintf(path, sizeof(path), "%s/crate.sock", dir);
+    unlink(path);
+    rmdir(dir);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,151 @@
+/***************************************************************************
+ *      ____  _____________  __    __  __ _           _____ ___   _        *
+ *     / __ \/ ____/ ___/\ \/ /   |  \/  (_)__ _ _ __|_   _/ __| /_\  (R)  *
+ *    / / / / __/  \__ \  \  /    | |\/| | / _| '_/ _ \| || (__ / _ \      *
+ *   / /_/ / /___ ___/ /  / /     |_|  |_|_\__|_| \___/|_| \___/_/ \_\     *
+ *  /_____/_____//____/  /_/      T  E  C  H  N  O  L  O  G  Y   L A B     *
+ *                                                                         *
+ *          Copyright 2022 Deutsches Elektronen-Synchrotron DESY.          *
+ *                          All rights reserved.                           *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+// Test: snapshot validation bitmap
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "mmcmb/fpga_mailbox_layout.h"
+#include "mmcmb/mmcmb_validate.h"
+
+#define CHECK(cond)                                                                 \
+    do {                                                                            \
+        if (!(cond)) {                                                              \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return false;                                                           \
+        }                                                                           \
+    } while (0)
+
+// A snapshot where every field is valid
+static void make_snapshot(mb_memory_contents_t* mb)
+{
+    memset(mb, 0, sizeof(*mb));
+    memcpy(mb->mailbox_magic_str, MB_MAGIC_STR, sizeof(mb->mailbox_magic_str));
+    mb->mailbox_version = MB_VERSION_MAX;
+    strcpy(mb->mmc_information.board_name, "TEST");
+    for (size_t f = 0; f < NUM_FRUS; f++) {
+        mb_fru_information_t* fru = &mb->fru_information[f];
+        fru->status.num_temp_sensors = MAX_SENS_PER_FRU;
+        strcpy(fru->description.manufacturer, "DESY");
+        strcpy(fru->description.product, "Board");
+        strcpy(fru->description.part_nr, "1234");
+        strcpy(fru->description.serial_nr, "5678");
+        memset(fru->description.version, 'v', sizeof(fru->description.version));
+    }
+    for (size_t i = 0; i < MAX_SENS_MMC; i++) {
+        snprintf(mb->mmc_sensor[i].name, sizeof(mb->mmc_sensor[i].name), "SENSOR%zu", i);
+        mb->mmc_sensor[i].reading = i;
+    }
+}
+
+static bool all_valid(const mb_validity_t* v)
+{
+    for (unsigned bit = 0; bit < MB_VALID_NUM_BITS; bit++) {
+        if (bit >= MB_VALID_FRU_STR(NUM_FRUS, 0) && bit < MB_VALID_MMC_SENSOR_0) {
+            CHECK(!mb_is_valid(v, bit));
+        } else if (!mb_is_valid(v, bit)) {
+            fprintf(stderr, "bit %u not set\n", bit);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Count the bits set, so each case can check that only the expected bits changed
+static unsigned num_valid(const mb_validity_t* v)
+{
+    unsigned n = 0;
+    for (unsigned bit = 0; bit < MB_VALID_NUM_BITS; bit++) {
+        n += mb_is_valid(v, bit);
+    }
+    return n;
+}
+
+static bool test_validate(void)
+{
+    mb_memory_contents_t mb;
+    mb_validity_t v;
+    make_snapshot(&mb);
+    mb_validate_snapshot(&mb, &v);
+    CHECK(all_valid(&v));
+    const unsigned n_all = num_valid(&v);
+
+    // Header and control bits
+    mb.mailbox_magic_str[0] = 'X';
+    mb.mailbox_version = MB_VERSION_MAX + 1;
+    mb.fpga_ctrl.reserved = 1;
+    mb.fpga_status.reserved = 4;
+    mb_validate_snapshot(&mb, &v);
+    CHECK(!mb_is_valid(&v, MB_VALID_MAGIC) && !mb_is_valid(&v, MB_VALID_VERSION));
+    CHECK(!mb_is_valid(&v, MB_VALID_FPGA_CTRL) && !mb_is_valid(&v, MB_VALID_FPGA_STATUS));
+    CHECK(num_valid(&v) == n_all - 4);
+
+    // Strings: non-printable characters, text after the zero padding; empty is fine
+    make_snapshot(&mb);
+    mb.mmc_information.board_name[1] = '\n';
+    mb_fru_description_t* desc = &mb.fru_information[1].description;
+    desc->product[10] = 'x';
+    memset(desc->serial_nr, 0, sizeof(desc->serial_nr));
+    desc->version[sizeof(desc->version) - 1] = (char)0x80;
+    mb_validate_snapshot(&mb, &v);
+    CHECK(!mb_is_valid(&v, MB_VALID_BOARD_NAME));
+    CHECK(!mb_is_valid(&v, MB_VALID_FRU_STR(1, MB_FRU_PRODUCT)));
+    CHECK(mb_is_valid(&v, MB_VALID_FRU_STR(1, MB_FRU_SERIAL_NR)));
+    CHECK(!mb_is_valid(&v, MB_VALID_FRU_STR(1, MB_FRU_VERSION)));
+    CHECK(mb_is_valid(&v, MB_VALID_FRU_STR(0, MB_FRU_PRODUCT)));
+    CHECK(num_valid(&v) == n_all - 3);
+
+    // FRU status and temperatures
+    make_snapshot(&mb);
+    mb.fru_information[0].status.status_reserved = 1;
+    mb.fru_information[1].status.num_temp_sensors = 2;
+    mb.fru_information[2].status.ext.fmc.reserved_2 = 1;
+    mb.fru_information[3].status.temperature[5] = FRU_TEMP_INVALID;
+    mb_validate_snapshot(&mb, &v);
+    CHECK(!mb_is_valid(&v, MB_VALID_FRU_STATUS(0)) && mb_is_valid(&v, MB_VALID_FRU_TEMP(0, 0)));
+    CHECK(mb_is_valid(&v, MB_VALID_FRU_TEMP(1, 1)) && !mb_is_valid(&v, MB_VALID_FRU_TEMP(1, 2)));
+    CHECK(!mb_is_valid(&v, MB_VALID_FRU_STATUS(2)));
+    CHECK(!mb_is_valid(&v, MB_VALID_FRU_TEMP(3, 5)) && mb_is_valid(&v, MB_VALID_FRU_TEMP(3, 6)));
+    CHECK(num_valid(&v) == n_all - 2 - (MAX_SENS_PER_FRU - 2) - 1);
+    mb.fru_information[1].status.num_temp_sensors = MAX_SENS_PER_FRU + 1;
+    mb_validate_snapshot(&mb, &v);
+    CHECK(!mb_is_valid(&v, MB_VALID_FRU_STATUS(1)));
+
+    // MMC sensors: unnamed, no reading, malformed name
+    make_snapshot(&mb);
+    memset(mb.mmc_sensor[0].name, 0, sizeof(mb.mmc_sensor[0].name));
+    mb.mmc_sensor[7].reading = NAN;
+    memset(mb.mmc_sensor[MAX_SENS_MMC - 1].name, 'A', sizeof(mb.mmc_sensor[0].name));
+    mb.mmc_sensor[MAX_SENS_MMC - 1].name[3] = '\t';
+    mb_validate_snapshot(&mb, &v);
+    CHECK(!mb_is_valid(&v, MB_VALID_MMC_SENSOR(0)) && mb_is_valid(&v, MB_VALID_MMC_SENSOR(1)));
+    CHECK(!mb_is_valid(&v, MB_VALID_MMC_SENSOR(7)));
+    CHECK(!mb_is_valid(&v, MB_VALID_MMC_SENSOR(MAX_SENS_MMC - 1)));
+    CHECK(num_valid(&v) == n_all - 3);
+
+    // A name filling the whole field is well-formed
+    mb.mmc_sensor[MAX_SENS_MMC - 1].name[3] = 'A';
+    mb_validate_snapshot(&mb, &v);
+    CHECK(mb_is_valid(&v, MB_VALID_MMC_SENSOR(MAX_SENS_MMC - 1)));
+    return true;
+}
+
+int main(void)
+{
+    return test_validate() ? 0 : 1;
+}